@@ -35,6 +35,7 @@
 #include <iostream>
 #include <map>
 #include <string>
+#include <vector>
 #include <stdlib.h>
 
 #define MIN_VLAN_ID         1
@@ -42,8 +43,22 @@
 #define SYSTEM_DEFAULT_VLAN 1
 #define NAS_VLAN_ID_INVALID 0
 
+/*  Member whose vlan membership is programmed in the NPU with the rest of its memberlist */
+typedef struct _nas_1q_npu_batch_mem_t {
+    std::string     if_name;    /* phy or LAG */
+    hal_ifindex_t   if_index;
+    nas_int_type_t  int_type;
+    ndi_port_t      ndi_port;
+    ndi_obj_id_t    lag_id;
+} nas_1q_npu_batch_mem_t;
+
 class NAS_DOT1Q_BRIDGE : public NAS_BRIDGE {
 
+    private:
+        bool npu_batch_active;
+        std::vector<nas_1q_npu_batch_mem_t> npu_batch;
+        t_std_error nas_bridge_npu_batch_flush(nas_port_mode_t port_mode, bool add);
+
     public:
         hal_vlan_id_t       bridge_vlan_id;
         BASE_IF_VLAN_TYPE_t bridge_sub_type; /*  DATA/MGMT */
@@ -62,6 +77,7 @@ class NAS_DOT1Q_BRIDGE : public NAS_BRIDGE {
                                                                bridge_sub_type = BASE_IF_VLAN_TYPE_DATA;
                                                                bridge_vlan_id = NAS_VLAN_ID_INVALID;
                                                                l3_mode            = BASE_IF_MODE_MODE_L3;
+                                                               npu_batch_active   = false;
                                                            }
         virtual ~NAS_DOT1Q_BRIDGE(){}
         t_std_error nas_bridge_npu_create();
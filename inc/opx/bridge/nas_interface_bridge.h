@@ -119,8 +119,10 @@ class NAS_BRIDGE {
         t_std_error nas_bridge_remove_vlan_member_from_attached_list(std::string mem_name);
         t_std_error nas_bridge_remove_tagged_member_from_list(std::string mem_name);
         t_std_error nas_bridge_remove_untagged_member_from_list(std::string mem_name);
-        t_std_error nas_bridge_set_tag_untag_drop(hal_ifindex_t ifx, ndi_port_t *port); /* For ethernet port */
-        t_std_error nas_bridge_set_lag_tag_untag_drop(npu_id_t npu_id, ndi_obj_id_t lag_id ,hal_ifindex_t ifx);
+        /* Drop attributes are only written when they change, force rewrites both of them */
+        t_std_error nas_bridge_set_tag_untag_drop(hal_ifindex_t ifx, ndi_port_t *port, bool force = false); /* For ethernet port */
+        t_std_error nas_bridge_set_lag_tag_untag_drop(npu_id_t npu_id, ndi_obj_id_t lag_id ,hal_ifindex_t ifx,
+                                                      bool force = false);
         cps_api_return_code_t nas_bridge_fill_com_info(cps_api_object_t obj);
 
         bool is_source_cps (void) { return source_cps;}
@@ -84,6 +84,8 @@ t_std_error nas_bridge_utils_npu_remove_member(const char *br_name, nas_int_type
 
 t_std_error nas_bridge_utils_add_remote_endpoint(const char *vxlan_intf_name, remote_endpoint_t & endpoint);
 t_std_error nas_bridge_utils_remove_remote_endpoint(const char *vxlan_intf_name, remote_endpoint_t & endpoint);
+t_std_error nas_bridge_utils_add_remote_endpoints(const char *vxlan_intf_name, std::list<remote_endpoint_t> & endpoints);
+t_std_error nas_bridge_utils_remove_remote_endpoints(const char *vxlan_intf_name, std::list<remote_endpoint_t> & endpoints);
 t_std_error nas_bridge_utils_update_remote_endpoint(const char * vxlan_intf_name, remote_endpoint_t & endpoint);
 
 /*  Generic API to add and delete a Member to a bridge in both kernel and NPU */
@@ -70,7 +70,8 @@ t_std_error hal_create_interfaces(void);
  * Send a packet on an interface
  * @param npu target switch
  * @param port valid target logical port (relative to npu)
- * @param queue the queue id to use
+ * @param queue the queue id to use, or a negative value to pick the queue from
+ *        the flow hash of the packet
  * @param data the data packet to send
  * @param len length of the packet
  * @return standard return code
@@ -78,10 +79,25 @@ t_std_error hal_create_interfaces(void);
 t_std_error hal_virtual_interface_send(npu_id_t npu, npu_port_t port, int queue,
         const void * data, unsigned int len);
 
+/**
+ * Print the per port counters of packets sent to the virtual interfaces
+ */
+void hal_virtual_interface_dbg_counters(void);
+
 //! the callback that will be used to process a packet
 typedef void (*hal_virt_pkt_transmit)(npu_id_t npu, npu_port_t port,
         void *data, unsigned int len);
 
+//! a packet read from a virtual interface
+typedef struct _hal_virt_pkt_t {
+    void *data;
+    unsigned int len;
+} hal_virt_pkt_t;
+
+//! the callback that will be used to process a burst of packets read from one port
+typedef void (*hal_virt_pkt_transmit_burst)(npu_id_t npu, npu_port_t port,
+        hal_virt_pkt_t *pkts, size_t count);
+
 //! the callback that will be used to process a packet and transmit to ingress pipeline
 typedef void (*hal_virt_pkt_transmit_to_ingress_pipeline)(void *data, unsigned int len);
 typedef void (*hal_virt_pkt_transmit_to_ingress_pipeline_hybrid)(void *data, unsigned int len, ndi_packet_tx_type_t tx_type,
@@ -90,11 +106,14 @@ typedef void (*hal_virt_pkt_transmit_to_ingress_pipeline_hybrid)(void *data, uns
 /**
  * Wait for a packet and call the callback function based on the correct npu,port
  * @param fun callback function to call with the correct params
+ * @param tx_burst_fun callback function to call with all the packets read from
+ *        a port in one go, NULL to call fun for each packet
  * @param buff to use to hold the received data packet
  * @param len is the length of the packet
  * @return standard return code
  */
 t_std_error hal_virtual_interface_wait(hal_virt_pkt_transmit tx_fun,
+        hal_virt_pkt_transmit_burst tx_burst_fun,
         hal_virt_pkt_transmit_to_ingress_pipeline tx_to_ingress_fun,
         hal_virt_pkt_transmit_to_ingress_pipeline_hybrid tx_to_ingress_hybrid_fun,
         void *buff, unsigned int len);
@@ -137,6 +156,14 @@ void nas_send_admin_state_event(hal_ifindex_t if_index, IF_INTERFACES_STATE_INTE
 typedef void (*oper_state_handler_t) (npu_id_t npu, npu_port_t port, IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_t oper_state);
 
 void nas_int_oper_state_register_cb(oper_state_handler_t oper_state_cb);
+
+/**
+ * Register a handler run on the NDI notification thread as soon as a port
+ * changes state, ahead of the handlers above. It must be short and must not
+ * wait on the NAS locks. Up to NAS_INT_OPER_STATE_FAST_CB_MAX handlers.
+ */
+#define NAS_INT_OPER_STATE_FAST_CB_MAX 4
+void nas_int_oper_state_register_fast_cb(oper_state_handler_t oper_state_cb);
 /**
  * Handles remote endpoint addition and deletion to a vxlan interface
  * */
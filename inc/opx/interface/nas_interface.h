@@ -86,6 +86,7 @@ class NAS_INTERFACE {
                         egress_split_horizon_id = 0;
                         br_mem_type = MEMBER_TYPE_NONE;
                         untagged_vlan_id = 1;
+                        mtu = 0;
 
         }
 
@@ -187,6 +188,16 @@ class NAS_INTERFACE {
             return rc;
         }
 
+        size_t sub_intf_count() const {
+            return sub_intf_list.size();
+        }
+
+        void for_each_sub_intf(std::function<void (const std::string &)> fn) const{
+            for(auto &intf : sub_intf_list){
+                fn(intf);
+            }
+        }
+
         void set_ingress_split_horizon_id(uint32_t id){
             ingress_split_horizon_id = id;
         }
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_interface_os_batch.h
+ *
+ * Create or delete a list of VLAN sub interfaces in the kernel with one
+ * netlink send per list.
+ */
+
+#ifndef _NAS_INTERFACE_OS_BATCH_H
+#define _NAS_INTERFACE_OS_BATCH_H
+
+#include "ds_common_types.h"
+#include "std_error_codes.h"
+
+#include <string>
+#include <vector>
+
+struct nas_os_subintf_req_t {
+    std::string if_name;
+    std::string parent_name;
+    hal_vlan_id_t vlan_id;
+    hal_ifindex_t if_index;     /* out for create, in for delete */
+    uint32_t mtu;               /* create only, 0 keeps the kernel default */
+    t_std_error rc;             /* result for this interface */
+
+    nas_os_subintf_req_t(const std::string &name, const std::string &parent, hal_vlan_id_t vlan,
+                         hal_ifindex_t ifindex, uint32_t mtu_val = 0) :
+        if_name(name), parent_name(parent), vlan_id(vlan), if_index(ifindex), mtu(mtu_val),
+        rc(STD_ERR(INTERFACE, FAIL, 0)) {}
+};
+
+typedef std::vector<nas_os_subintf_req_t> nas_os_subintf_req_list_t;
+
+/*
+ * Create the sub interfaces of the list in the kernel. The result and the
+ * kernel if-index of each one are returned in the request. Returns an error
+ * if any of them failed.
+ */
+t_std_error nas_os_subintf_batch_create(nas_os_subintf_req_list_t &reqs);
+
+/*
+ * Delete the sub interfaces of the list from the kernel by if-index. The
+ * result of each one is returned in the request.
+ */
+t_std_error nas_os_subintf_batch_delete(nas_os_subintf_req_list_t &reqs);
+
+#endif /* _NAS_INTERFACE_OS_BATCH_H */
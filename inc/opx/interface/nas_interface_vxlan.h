@@ -33,6 +33,7 @@
 #include <list>
 #include <functional>
 #include <map>
+#include <unordered_map>
 #include <netinet/in.h>
 
 #define NAS_INVALID_TUNNEL_ID ((ndi_obj_id_t ) ~0x0)
@@ -59,14 +60,41 @@ typedef std::map<hal_ip_addr_t, remote_endpoint_t> remote_endpoint_map_t;
 typedef std::pair<hal_ip_addr_t, remote_endpoint_t> remote_endpoint_pair_t;
 typedef std::pair<remote_endpoint_map_t::iterator, bool> remote_endpoint_ret_t;
 
+/*  Hash and equality on the remote IP, so the endpoint index can be keyed on hal_ip_addr_t */
+struct remote_endpoint_ip_hash_t {
+    size_t operator()(const hal_ip_addr_t &ip) const noexcept {
+        const uint8_t *p = (const uint8_t *)&ip.u;
+        size_t len = (ip.af_index == AF_INET) ? sizeof(ip.u.ipv4) : sizeof(ip.u.ipv6);
+        size_t h = 2166136261u ^ ip.af_index;
+        for (size_t i = 0; i < len; ++i) {
+            h = (h ^ p[i]) * 16777619u;
+        }
+        return h;
+    }
+};
+
+struct remote_endpoint_ip_equal_t {
+    bool operator()(const hal_ip_addr_t &ip1, const hal_ip_addr_t &ip2) const noexcept {
+        return (std_ip_cmp_ip_addr(&ip1, &ip2) == 0);
+    }
+};
+
+typedef std::list<remote_endpoint_t> remote_endpoint_list_t;
+typedef std::unordered_map<hal_ip_addr_t, remote_endpoint_list_t::iterator,
+                           remote_endpoint_ip_hash_t, remote_endpoint_ip_equal_t> remote_endpoint_index_t;
+
 class NAS_VXLAN_INTERFACE : public NAS_INTERFACE {
 
+    private:
+        /*  Remote endpoints in insertion order, indexed by remote IP */
+        remote_endpoint_list_t       remote_endpoint_list;
+        remote_endpoint_index_t      remote_endpoint_index;
+
     public:
         BASE_CMN_VNI_t               vni;
         hal_ip_addr_t                source_ip;
         uint64_t                     learning_mode;
         std::string                  bridge_name;
-        std::list<remote_endpoint_t> remote_endpoint_list;
 
         NAS_VXLAN_INTERFACE(std::string if_name,
                          hal_ifindex_t if_index,
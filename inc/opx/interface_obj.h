@@ -33,6 +33,9 @@ typedef cps_api_return_code_t (*cps_rdfn) (void * context, cps_api_get_params_t
 
 typedef cps_api_return_code_t (*cps_wrfn) (void * context, cps_api_transaction_params_t * param,size_t ix);
 
+/* Fill in one interface of a wildcard get from the OS interface dump, false to leave it out */
+typedef bool (*cps_fillfn) (void * context, cps_api_object_t obj, const interface_ctrl_t *intf);
+
 typedef enum {
     obj_INTF,
     obj_INTF_STATE,
@@ -44,6 +47,13 @@ t_std_error interface_obj_init(cps_api_operation_handle_t handle);
 
 t_std_error intf_obj_handler_registration(obj_intf_cat_t obj_cat, nas_int_type_t intf_type, cps_rdfn rd, cps_wrfn wr);
 
+/*
+ * Optional, after intf_obj_handler_registration. A get of all interfaces dumps the OS
+ * interfaces once and hands each one to the fill handler of its type instead of calling
+ * the get handler of every such type.
+ */
+t_std_error intf_obj_fill_registration(obj_intf_cat_t obj_cat, nas_int_type_t intf_type, cps_fillfn fill);
+
 #ifdef __cplusplus
 }
 #endif
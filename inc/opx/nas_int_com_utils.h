@@ -75,6 +75,10 @@ bool nas_intf_cleanup_l3mc_rpc_action(BASE_CLEANUP_EVENT_TYPE_t event, cleanup_e
 bool nas_intf_cleanup_l2mc_config (hal_ifindex_t ifx,  hal_vlan_id_t vlan_id=0);
 
 bool if_data_from_obj(obj_intf_cat_t obj_cat, cps_api_object_t o, interface_ctrl_t& i);
+
+/* Keep the objects of the list keep returns true for and delete the others, in one pass */
+void nas_intf_obj_list_filter(cps_api_object_list_t list, std::function<bool (cps_api_object_t)> keep);
+
 bool nas_base_to_ietf_state_speed(BASE_IF_SPEED_t speed, uint64_t *ietf_speed);
 
 /* publish a loopback event */
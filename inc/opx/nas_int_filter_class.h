@@ -30,7 +30,9 @@
 #include <iostream>
 #include <unordered_map>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 //Key hash based on enum type
 template<typename T>
@@ -41,13 +43,13 @@ public:
 };
 
 template<>
-std::size_t pf_key_hash<BASE_PACKET_PACKET_MATCH_TYPE_t>::operator()
+inline std::size_t pf_key_hash<BASE_PACKET_PACKET_MATCH_TYPE_t>::operator()
              (BASE_PACKET_PACKET_MATCH_TYPE_t const& idx) const  noexcept{
     return std::hash<int>() (idx);
 }
 
 template<>
-std::size_t pf_key_hash<BASE_PACKET_PACKET_ACTION_TYPE_t>::operator()
+inline std::size_t pf_key_hash<BASE_PACKET_PACKET_ACTION_TYPE_t>::operator()
              (BASE_PACKET_PACKET_ACTION_TYPE_t const& idx) const  noexcept{
     return std::hash<int>() (idx);
 }
@@ -277,6 +279,40 @@ private:
     bool stop = true;
 };
 
+/*
+ * Compiled view of the ingress or egress rules used by the packet handlers.
+ * Rules are indexed on user trap id and destination MAC, rules matching on
+ * neither are kept in a wildcard list. It is rebuilt on every rule change and
+ * never modified once published.
+ */
+class pf_classifier final {
+
+public:
+    explicit pf_classifier(const std::vector<pf_rule>& rules);
+
+    inline size_t pf_c_get_count() const { return entries.size(); }
+
+    //Run the actions of the matching rules, return true if a stop rule matched
+    bool pf_c_classify(uint8_t *, uint32_t, pf_pkt_attr *);
+
+private:
+    struct pf_c_entry {
+        nas_obj_id_t id;
+        bool stop;
+        //Rule is indexed on trap id and also matches on destination MAC
+        bool chk_mac = false;
+        hal_mac_addr_t mac;
+        pf_action action_lst;
+        std::vector<pf_action_t> actions;
+    };
+
+    //Entries in rule order, the lists below hold indexes into it in ascending order
+    std::vector<pf_c_entry> entries;
+    std::unordered_map<uint64_t, std::vector<size_t>> by_trap_id;
+    std::unordered_map<uint64_t, std::vector<size_t>> by_mac;
+    std::vector<size_t> wildcard;
+};
+
 //Packet Filter Main Table
 class pf_table {
 
@@ -304,14 +340,18 @@ public:
     //Packet handler APIs
     bool pf_t_in_pkt_hndlr(uint8_t *, uint32_t, pf_pkt_attr*);
     bool pf_t_out_pkt_hndlr(uint8_t *, uint32_t, pf_pkt_attr*);
+    void pf_t_out_pkt_burst_hndlr(uint8_t **, uint32_t *, pf_pkt_attr*, size_t);
 
     friend bool pf_gen_erase_id(std::vector<pf_rule>&, nas_obj_id_t& );
     friend const pf_rule* pf_gen_get_id(const std::vector<pf_rule>&, nas_obj_id_t& );
 
 private:
+    //Rebuild and publish the classifier of a direction, called with pf_mtx held
+    void pf_t_compile(pf_direction dir);
+
     const size_t pf_max_id = 256;
 
-    //Table safe-access - Lock all operations
+    //Table safe-access - Lock all rule operations, packet handlers use the classifiers
     std::mutex pf_mtx;
 
     //Rules count
@@ -324,6 +364,10 @@ private:
     //Primary tables for ingress/egress rules
     std::vector<pf_rule> pf_ingress_table;
     std::vector<pf_rule> pf_egress_table;
+
+    //Compiled tables for the packet handlers - swapped atomically on rule changes
+    std::shared_ptr<pf_classifier> pf_ingress_cls;
+    std::shared_ptr<pf_classifier> pf_egress_cls;
 };
 
 #endif /* NAS_INT_FILTER_CLASS_H_ */
@@ -30,6 +30,7 @@
 #include "dell-base-if-phy.h"
 
 #include <stdlib.h>
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -158,7 +159,16 @@ std_mutex_type_t  *nas_lag_mutex_lock();
 
 
 nas_lag_master_info_t *nas_get_lag_node(hal_ifindex_t index);
+nas_lag_master_info_t *nas_get_lag_node_by_ndi_id(ndi_obj_id_t ndi_lag_id);
 nas_lag_master_table_t & nas_get_lag_table(void);
+
+/**
+ * @brief Visit the LAG master table in place, without copying it
+ *
+ * @param fn - called for each LAG, return false to stop the walk. Must not
+ *             add or remove LAGs.
+ */
+void nas_lag_for_each(std::function<bool (nas_lag_master_info_t &)> fn);
 t_std_error nas_lag_set_desc(hal_ifindex_t index,const char *desc);
 t_std_error nas_lag_set_mac(hal_ifindex_t index,const char *lag_mac);
 t_std_error nas_lag_set_admin_status(hal_ifindex_t index, bool enable);
@@ -172,6 +182,24 @@ cps_api_return_code_t lag_object_publish(nas_lag_master_info_t *nas_lag_entry,ha
 
 t_std_error nas_lag_get_ndi_lag_id(hal_ifindex_t lag_index, ndi_obj_id_t *ndi_lag_id);
 
+/**
+ * @brief Find the LAG member on an NPU port, without the LAG lock
+ *
+ * @param ifindex - ifindex of the member port if found
+ *
+ * @return true if the port is a LAG member
+ */
+bool nas_lag_port_member_get(npu_id_t npu, npu_port_t port, hal_ifindex_t *ifindex);
+
+/**
+ * @brief Egress disable the LAG member on an NPU port, without the LAG lock
+ *
+ * @param found - set if the port is a LAG member
+ *
+ * @return true if the member was disabled
+ */
+bool nas_lag_port_member_egress_disable(npu_id_t npu, npu_port_t port, bool *found);
+
 
 #endif /* NAS_INTF_LAG_API_H__ */
 
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * nas_int_link_event.h
+ *
+ * Link state events from the NDI are queued per port and handled by a pool of
+ * worker threads, so the NDI notification thread never waits on the handlers.
+ * Events of a port that is still queued collapse into its latest state and the
+ * CPS events published while handling are sent in batches.
+ */
+
+#ifndef NAS_INT_LINK_EVENT_H_
+#define NAS_INT_LINK_EVENT_H_
+
+#include "std_error_codes.h"
+#include "ds_common_types.h"
+#include "cps_api_object.h"
+#include "hal_interface_common.h"
+
+/* Worker threads handling link state events */
+#define NAS_INT_LINK_EVT_WORKERS    4
+
+/* Events collected before the workers publish them */
+#define NAS_INT_LINK_EVT_BATCH      32
+
+/**
+ * Start the link state event workers
+ * @param dispatch handles the latest state of a port on a worker thread; the
+ *        events of one port are never handled by two workers at a time
+ * @return standard return code
+ */
+t_std_error nas_int_link_event_init(oper_state_handler_t dispatch);
+
+/**
+ * Queue the state of a port. Handled inline if the workers are not running.
+ */
+void nas_int_link_event_post(npu_id_t npu, npu_port_t port,
+                             IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_t status);
+
+/**
+ * Add an event to the batch of the calling link state worker
+ * @param obj the event, copied if it was added
+ * @return false if not called on a link state worker, the event is not added
+ */
+bool nas_int_link_event_batch_add(cps_api_object_t obj);
+
+#endif /* NAS_INT_LINK_EVENT_H_ */
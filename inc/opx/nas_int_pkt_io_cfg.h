@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * nas_int_pkt_io_cfg.h
+ *
+ * Tunables for the packet I/O path, read from the packet I/O config file.
+ */
+
+#ifndef NAS_INT_PKT_IO_CFG_H_
+#define NAS_INT_PKT_IO_CFG_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NAS_PKT_IO_CFG_FILE "/etc/opx/nas_pkt_io_config.xml"
+
+/* largest sampled packet exported by sFlow */
+#define NAS_PKT_IO_MAX_SFLOW_HEADER_LEN 9216
+
+typedef struct _nas_pkt_io_cfg_t {
+    size_t tap_reader_threads;  // number of threads reading packets from TAP fds
+    size_t tap_queues;          // number of queues (fds) opened per TAP interface
+    size_t tap_burst;           // max packets read from a TAP queue per event
+    size_t tap_rx_backlog;      // max packets held per TAP queue while the kernel is busy
+    size_t sflow_ring;          // sFlow samples queued between NDI RX and the exporter
+    size_t sflow_batch;         // max sFlow samples sent per sendmmsg
+    size_t sflow_header_len;    // sampled packet bytes exported per sample, 0 for the whole packet
+} nas_pkt_io_cfg_t;
+
+/**
+ * Get the packet I/O configuration. The config file is loaded on first use;
+ * defaults are used for anything missing from the file.
+ * @return pointer to the (read-only) packet I/O configuration
+ */
+const nas_pkt_io_cfg_t * nas_pkt_io_cfg_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NAS_INT_PKT_IO_CFG_H_ */
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * nas_int_pkt_io_stats.h
+ *
+ * Packet I/O statistics. Every thread updates its own cache line aligned
+ * counter block without atomics or locks; the blocks are added up when the
+ * statistics are read.
+ */
+
+#ifndef NAS_INT_PKT_IO_STATS_H_
+#define NAS_INT_PKT_IO_STATS_H_
+
+#include "ds_common_types.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    NAS_PKT_IO_CNT_RX,                      // received from the NPU
+    NAS_PKT_IO_CNT_RX_FILTERED,             // consumed by the packet filter
+    NAS_PKT_IO_CNT_TX,                      // sent to the NPU, total
+    NAS_PKT_IO_CNT_TX_BYPASS,               // sent bypassing the pipeline
+    NAS_PKT_IO_CNT_TX_LOOKUP,               // sent to the ingress pipeline
+    NAS_PKT_IO_CNT_TX_LOOKUP_HYBRID,        // sent to the ingress pipeline hybrid
+    NAS_PKT_IO_CNT_NFLOG_TX_LOOKUP,         // nflog copies sent to the ingress pipeline
+    NAS_PKT_IO_CNT_NFLOG_TX_LOOKUP_HYBRID,  // nflog copies sent to the ingress pipeline hybrid
+    NAS_PKT_IO_CNT_MAX
+} nas_pkt_io_cnt_t;
+
+typedef enum {
+    NAS_PKT_IO_DROP_RX_TAP,                 // write to the tap interface failed
+    NAS_PKT_IO_DROP_TX_NDI,                 // NDI transmit failed
+    NAS_PKT_IO_DROP_TX_LOOKUP_NDI,          // NDI transmit to the ingress pipeline failed
+    NAS_PKT_IO_DROP_NFLOG_NO_PAYLOAD,       // nflog message without payload
+    NAS_PKT_IO_DROP_NFLOG_NO_INTF,          // nflog out interface not found
+    NAS_PKT_IO_DROP_NFLOG_FLOOD,            // nflog copy not sent to the ingress pipeline
+    NAS_PKT_IO_DROP_NFLOG_FLOOD_HYBRID,     // nflog copy not sent to the ingress pipeline hybrid
+    NAS_PKT_IO_DROP_MAX
+} nas_pkt_io_drop_t;
+
+typedef enum {
+    NAS_PKT_IO_LAT_RX_TO_TAP,               // NDI RX callback until the tap write is done
+    NAS_PKT_IO_LAT_TAP_TO_NDI,              // tap read until NDI transmit is done
+    NAS_PKT_IO_LAT_MAX
+} nas_pkt_io_lat_t;
+
+/* Latency bucket 0 is below 1us, bucket n (n > 0) is [2^(n-1), 2^n) us and the
+ * last bucket takes everything above */
+#define NAS_PKT_IO_LAT_BUCKETS      16
+
+/* npus and npu ports counted individually */
+#define NAS_PKT_IO_STATS_MAX_NPUS   4
+#define NAS_PKT_IO_STATS_MAX_PORTS  512
+
+/* trap ids counted individually, the rest are counted as other */
+#define NAS_PKT_IO_STATS_MAX_TRAPS  32
+
+typedef struct _nas_pkt_io_trap_stats_t {
+    uint64_t trap_id;
+    uint64_t rx;
+} nas_pkt_io_trap_stats_t;
+
+typedef struct _nas_pkt_io_stats_t {
+    uint64_t cnt[NAS_PKT_IO_CNT_MAX];
+    uint64_t drop[NAS_PKT_IO_DROP_MAX];
+    uint64_t port_rx[NAS_PKT_IO_STATS_MAX_NPUS][NAS_PKT_IO_STATS_MAX_PORTS];
+    uint64_t port_tx[NAS_PKT_IO_STATS_MAX_NPUS][NAS_PKT_IO_STATS_MAX_PORTS];
+    nas_pkt_io_trap_stats_t trap[NAS_PKT_IO_STATS_MAX_TRAPS];
+    size_t trap_count;
+    uint64_t trap_other_rx;
+    uint64_t lat[NAS_PKT_IO_LAT_MAX][NAS_PKT_IO_LAT_BUCKETS];
+} nas_pkt_io_stats_t;
+
+/**
+ * Monotonic time stamp for the latency histograms
+ * @return time in ns
+ */
+uint64_t nas_pkt_io_stats_now(void);
+
+/**
+ * Update the counters of the calling thread
+ */
+void nas_pkt_io_stats_inc(nas_pkt_io_cnt_t cnt, uint64_t val);
+void nas_pkt_io_stats_drop(nas_pkt_io_drop_t reason, uint64_t val);
+void nas_pkt_io_stats_port_rx(npu_id_t npu, npu_port_t port, uint64_t trap_id);
+void nas_pkt_io_stats_port_tx(npu_id_t npu, npu_port_t port, uint64_t val);
+
+/**
+ * Add packets to a latency histogram
+ * @param lat the histogram
+ * @param start time stamp taken with nas_pkt_io_stats_now when the packets were picked up
+ * @param pkts number of packets handled since start
+ */
+void nas_pkt_io_stats_latency(nas_pkt_io_lat_t lat, uint64_t start, uint64_t pkts);
+
+/**
+ * Add up the counters of all threads
+ * @param stats filled with the statistics since the last clear
+ */
+void nas_pkt_io_stats_get(nas_pkt_io_stats_t *stats);
+
+/**
+ * Clear all statistics, or a single counter
+ */
+void nas_pkt_io_stats_clear(void);
+void nas_pkt_io_stats_clear_cnt(nas_pkt_io_cnt_t cnt);
+void nas_pkt_io_stats_clear_drop(nas_pkt_io_drop_t reason);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NAS_INT_PKT_IO_STATS_H_ */
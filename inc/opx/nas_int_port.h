@@ -48,8 +48,37 @@ bool nas_int_port_name_used(const char *name);
 
 t_std_error nas_int_port_init(void);
 
+/**
+ * Set up the linux tap of a port ahead of nas_int_port_create_*, without
+ * taking the port table lock, so taps of several ports can be set up in
+ * parallel. The create then reuses the tap.
+ * @param name of the port
+ * @return standard return code
+ */
+t_std_error nas_int_port_tap_prepare(const char *name);
+
+/**
+ * Forget the taps set up with nas_int_port_tap_prepare that were not used
+ */
+void nas_int_port_tap_prepare_clear(void);
+
 bool nas_int_port_ifindex (npu_id_t npu, port_t port, hal_ifindex_t *ifindex);
 
+typedef struct _nas_int_port_info_t {
+    npu_id_t npu;
+    port_t port;
+    hal_ifindex_t ifindex;
+    char name[HAL_IF_NAME_SZ];
+} nas_int_port_info_t;
+
+/**
+ * List the mapped npu ports, ordered by npu and port
+ * @param list filled with up to max ports, can be NULL when max is 0
+ * @param max size of the list
+ * @return number of mapped ports, can be larger than max
+ */
+size_t nas_int_port_info_list (nas_int_port_info_t *list, size_t max);
+
 t_std_error nas_int_update_npu_port(const char *name, npu_id_t npu, port_t port,
                                     bool connect);
 
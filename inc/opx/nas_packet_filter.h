@@ -100,6 +100,17 @@ bool nas_pf_in_pkt_hndlr(uint8_t *pkt, uint32_t pkt_len, ndi_packet_attr_t *p_at
  */
 bool nas_pf_out_pkt_hndlr(uint8_t *pkt, uint32_t pkt_len, ndi_packet_attr_t *p_attr);
 
+/**
+ * @brief : API to process a burst of out-bound packets via packet-filter engine
+ * @param pkt : array of pointers to packet buffers
+ * @param pkt_len : array of packet buffer lengths
+ * @param p_attr : array of packet attributes, updated by the matching rules
+ * @param count : number of packets in the burst
+ * @return : none
+ */
+void nas_pf_out_pkt_burst_hndlr(uint8_t **pkt, uint32_t *pkt_len, ndi_packet_attr_t *p_attr,
+                                size_t count);
+
 /**
  * @brief : API to create/delete packet filter rules
  * @param obj : the result object
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * nas_sflow_export.h
+ *
+ * Export of sFlow samples to the sFlow agent. Samples are queued by the NDI
+ * RX callback and sent by a dedicated exporter thread, so a high sampling
+ * rate does not slow down the packet receive path.
+ */
+
+#ifndef NAS_SFLOW_EXPORT_H_
+#define NAS_SFLOW_EXPORT_H_
+
+#include "std_error_codes.h"
+#include "ds_common_types.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _nas_sflow_export_stats_t {
+    uint64_t enqueued;          // samples queued for export
+    uint64_t exported;          // samples sent to the sFlow agent
+    uint64_t truncated;         // samples cut down to the configured header length
+    uint64_t batches;           // sendmmsg calls
+    uint64_t drop_overflow;     // dropped because the queue was full
+    uint64_t drop_no_port;      // dropped because the rx port has no interface
+    uint64_t drop_send_err;     // dropped on a socket error
+    uint64_t drop_unsent;       // dropped because the socket took none of a batch
+} nas_sflow_export_stats_t;
+
+/**
+ * Create the export socket and start the exporter thread
+ * @return standard return code
+ */
+t_std_error nas_sflow_export_init(void);
+
+/**
+ * Queue a sampled packet for export. Called from the NDI RX callback; only
+ * one thread may queue samples.
+ * @param pkt the sampled packet
+ * @param pkt_len length of the packet
+ * @param rx_ifindex interface the packet was received on
+ * @param tx_ifindex interface the packet was sent out of or 0
+ * @return standard return code
+ */
+t_std_error nas_sflow_export_enqueue(const uint8_t *pkt, uint32_t pkt_len,
+                                     hal_ifindex_t rx_ifindex, hal_ifindex_t tx_ifindex);
+
+/**
+ * Count a sample dropped because its rx port has no interface
+ */
+void nas_sflow_export_drop_no_port(void);
+
+/**
+ * Get/Set the address samples are exported to
+ */
+void nas_sflow_export_dest_get(dn_ipv4_addr_t *ip, int *port);
+void nas_sflow_export_dest_set(const dn_ipv4_addr_t *ip, int port);
+
+/**
+ * Get a snapshot of the export counters
+ * @param stats filled with the counters
+ */
+void nas_sflow_export_stats_get(nas_sflow_export_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NAS_SFLOW_EXPORT_H_ */
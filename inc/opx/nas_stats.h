@@ -26,6 +26,9 @@
 #include "cps_api_operation.h"
 #include "nas_ndi_plat_stat.h" // nas_stat_type_t
 
+#include <stdbool.h>
+#include <linux/if_link.h> // rtnl_link_stats64
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -53,6 +56,9 @@ bool nas_stat_get_name_from_obj(cps_api_object_t obj, char *if_name, size_t name
 
 bool get_intf_stats_from_os( const char *name, cps_api_object_list_t list);
 
+/* Kernel counters of an interface, read over netlink */
+bool nas_stats_os_get_link_stats(const char *name, struct rtnl_link_stats64 *stats);
+
 cps_api_return_code_t nas_vlan_sub_intf_stat_clear(cps_api_object_t obj);
 
 t_std_error get_stat_ids_len(nas_stat_type_t type, unsigned int * len);
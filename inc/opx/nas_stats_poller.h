@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * nas_stats_poller.h
+ *
+ * Background statistics poller. When enabled for a counter group, a poller
+ * thread reads the counters of the group at a fixed interval into a snapshot
+ * and the stats GET handlers answer from the latest snapshot instead of
+ * reading the NPU, so the NPU load does not depend on how many clients poll.
+ */
+
+#ifndef NAS_STATS_POLLER_H_
+#define NAS_STATS_POLLER_H_
+
+#include "std_error_codes.h"
+#include "ds_common_types.h"
+
+#include <stdint.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define NAS_STATS_CFG_FILE "/etc/opx/nas_stats_config.xml"
+
+typedef enum {
+    NAS_STATS_GRP_PORT,
+    NAS_STATS_GRP_VLAN,
+    NAS_STATS_GRP_MAX
+} nas_stats_grp_t;
+
+/* Object polled in a group */
+struct nas_stats_obj_t {
+    hal_ifindex_t ifindex;
+    npu_id_t npu;
+    npu_port_t port;
+    std::string name;
+};
+
+/* Counters of one object, one value per stat id of the group */
+struct nas_stats_entry_t {
+    std::string name;
+    std::vector<uint64_t> values;
+    std::vector<uint64_t> deltas;       // change since the previous poll, 64 bit wrap safe
+    std::vector<uint64_t> rates;        // per second over the previous poll interval
+    bool has_delta = false;             // false on the first poll of the object
+    uint64_t gen = 0;
+};
+
+struct nas_stats_snapshot_t {
+    uint64_t poll_ms;                   // monotonic time of the poll
+    uint64_t interval_ms;               // time since the previous poll
+    uint64_t time_uptime;               // std_get_uptime at the poll
+    uint64_t time_from_epoch;           // ns from epoch at the poll
+    std::unordered_map<hal_ifindex_t, nas_stats_entry_t> entries;
+};
+
+typedef std::shared_ptr<const nas_stats_snapshot_t> nas_stats_snapshot_ptr;
+
+/* Read the counters of an object into values; may fill in the name */
+typedef std::function<bool (nas_stats_obj_t& obj, uint64_t *values)> nas_stats_read_fn;
+
+/* Objects polled whether they were asked for or not */
+typedef std::function<void (std::vector<nas_stats_obj_t>& objs)> nas_stats_list_fn;
+
+/**
+ * Register a counter group. Does nothing unless the poller is enabled for the
+ * group in the stats config file.
+ * @param grp the group
+ * @param stat_count number of counters read per object
+ * @param read reads the counters of an object
+ * @param list lists the objects of the group or nullptr to poll only the
+ *        objects asked for with nas_stats_poller_watch
+ * @return standard return code
+ */
+t_std_error nas_stats_poller_register(nas_stats_grp_t grp, size_t stat_count,
+                                      nas_stats_read_fn read, nas_stats_list_fn list);
+
+/**
+ * Latest snapshot of a group
+ * @return the snapshot, or nullptr if the group is not polled or the snapshot
+ *         is older than the configured max staleness
+ */
+nas_stats_snapshot_ptr nas_stats_poller_snapshot(nas_stats_grp_t grp);
+
+/**
+ * Poll an object of a group from now on. Objects that are not read for a
+ * number of poll intervals are dropped again.
+ */
+void nas_stats_poller_watch(nas_stats_grp_t grp, hal_ifindex_t ifindex);
+
+/**
+ * The counters of an object were cleared; drop it from the snapshot until the
+ * next poll so neither old values nor a bogus delta are returned.
+ */
+void nas_stats_poller_reset(nas_stats_grp_t grp, hal_ifindex_t ifindex);
+
+#endif /* NAS_STATS_POLLER_H_ */
@@ -23,6 +23,7 @@
 #define NAS_VRF_H_
 
 #include "std_error_codes.h"
+#include "ds_common_types.h"
 #include "cps_api_operation.h"
 
 #define NAS_VRF_LOG_ERR(ID, ...) EV_LOGGING(VRF, ERR, ID, __VA_ARGS__)
@@ -39,5 +40,8 @@ bool nas_vrf_update_vrf_id(const char *vrf_name, bool is_add);
 cps_api_return_code_t nas_vrf_get_intf_info(cps_api_object_list_t list, const char *vrf_name,
                                             const char *if_name);
 cps_api_return_code_t nas_vrf_get_router_intf_info(cps_api_object_list_t list, const char *if_name);
+cps_api_return_code_t nas_vrf_get_all_router_intf_info(cps_api_object_list_t list);
+/* Drop an unbound or deleted router interface from the router interface name cache */
+void nas_vrf_rt_intf_cache_del(hal_vrf_id_t vrf_id, hal_ifindex_t if_index);
 t_std_error nas_vrf_create_publish_handle();
 #endif /* NAS_VRF_H_ */
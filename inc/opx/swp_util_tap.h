@@ -39,6 +39,9 @@ extern "C" {
 #define SWP_UTIL_TYPE_TAP 1
 #define SWP_UTIL_TYPE_TUN 2
 
+/* maximum number of queues (fds) on a multi-queue tap */
+#define SWP_UTIL_TAP_QUEUE_LEN_MAX 10
+
 
 typedef struct _swp_util_tap_descr *swp_util_tap_descr;
 
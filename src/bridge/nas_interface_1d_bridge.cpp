@@ -548,7 +548,7 @@ t_std_error NAS_DOT1D_BRIDGE:: nas_bridge_associate_npu_port(std::string &mem_na
     rc =  _nas_npu_add_remove_port_member(if_index,port, bridge_id_get(), l2mc_group_id,
                                             vlan_id, port_mode,  associate);
     if (rc == STD_ERR_OK) {
-        nas_bridge_set_tag_untag_drop(if_index, port);
+        nas_bridge_set_tag_untag_drop(if_index, port, true);
     } else {
         EV_LOGGING(INTERFACE,ERR,"NAS-BRIDGE","assocaite NPU port : Failed to add member %s to the Vlan %d in the NPU",
             mem_name.c_str(), vlan_id);
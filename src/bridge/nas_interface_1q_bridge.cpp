@@ -87,41 +87,124 @@ t_std_error NAS_DOT1Q_BRIDGE::nas_bridge_npu_delete() {
 }
 
 // TODO Following functions can be moved to utils file
-static t_std_error _nas_npu_add_remove_port_to_vlan(ndi_port_t *ndi_port, hal_vlan_id_t vlan_id,
-                                nas_port_mode_t port_mode, bool add) {
-
-    t_std_error rc = STD_ERR_OK;
-    ndi_port_list_t port_list = {1, ndi_port};
+static t_std_error _nas_npu_add_remove_ports_to_vlan(npu_id_t npu_id, std::vector<ndi_port_t> &ports,
+                                hal_vlan_id_t vlan_id, nas_port_mode_t port_mode, bool add) {
+    ndi_port_list_t port_list;
+    port_list.port_count = ports.size();
+    port_list.port_list = ports.data();
     ndi_port_list_t *t_list = NULL, *ut_list = NULL;
     (port_mode == NAS_PORT_UNTAGGED) ?
         (ut_list = &port_list) : (t_list = &port_list);
     if (add) {
-        rc = ndi_add_ports_to_vlan(ndi_port->npu_id, vlan_id, t_list, ut_list);
-        if (port_mode == NAS_PORT_UNTAGGED) {
-             ndi_set_port_vid(ndi_port->npu_id, ndi_port->npu_port, vlan_id);
-        }
-    } else {
-        rc = ndi_del_ports_from_vlan(ndi_port->npu_id, vlan_id, t_list, ut_list);
+        return ndi_add_ports_to_vlan(npu_id, vlan_id, t_list, ut_list);
     }
-    return rc;
+    return ndi_del_ports_from_vlan(npu_id, vlan_id, t_list, ut_list);
 }
-static t_std_error _nas_npu_add_remove_lag_to_vlan(ndi_obj_id_t *lag_id, hal_vlan_id_t vlan_id,
+
+static t_std_error _nas_npu_add_remove_lags_to_vlan(std::vector<ndi_obj_id_t> &lags, hal_vlan_id_t vlan_id,
                                 nas_port_mode_t port_mode, bool add) {
-    t_std_error rc = STD_ERR_OK;
     ndi_obj_id_t *t_list = NULL, *ut_list = NULL;
     size_t tag_cnt =0, untag_cnt=0;
-    ndi_obj_id_t lag_list[] = {*lag_id};
-    size_t lag_count = sizeof(lag_list)/sizeof(ndi_obj_id_t);
 
-    (port_mode == NAS_PORT_UNTAGGED) ?  (ut_list = lag_list, untag_cnt = lag_count) :
-                                  (t_list = lag_list, tag_cnt = lag_count);
+    (port_mode == NAS_PORT_UNTAGGED) ?  (ut_list = lags.data(), untag_cnt = lags.size()) :
+                                  (t_list = lags.data(), tag_cnt = lags.size());
     if (add) {
-        rc  = ndi_add_lag_to_vlan(0, vlan_id, t_list, tag_cnt, ut_list, untag_cnt);
-        if (port_mode == NAS_PORT_UNTAGGED) {
-            ndi_set_lag_pvid(0, *lag_id, vlan_id);
+        return ndi_add_lag_to_vlan(0, vlan_id, t_list, tag_cnt, ut_list, untag_cnt);
+    }
+    return ndi_del_lag_from_vlan(0, vlan_id, t_list, tag_cnt, ut_list, untag_cnt);
+}
+
+static t_std_error _nas_npu_add_remove_port_to_vlan(ndi_port_t *ndi_port, hal_vlan_id_t vlan_id,
+                                nas_port_mode_t port_mode, bool add) {
+
+    std::vector<ndi_port_t> ports = {*ndi_port};
+    t_std_error rc = _nas_npu_add_remove_ports_to_vlan(ndi_port->npu_id, ports, vlan_id, port_mode, add);
+    if (add && port_mode == NAS_PORT_UNTAGGED) {
+        ndi_set_port_vid(ndi_port->npu_id, ndi_port->npu_port, vlan_id);
+    }
+    return rc;
+}
+static t_std_error _nas_npu_add_remove_lag_to_vlan(ndi_obj_id_t *lag_id, hal_vlan_id_t vlan_id,
+                                nas_port_mode_t port_mode, bool add) {
+    std::vector<ndi_obj_id_t> lags = {*lag_id};
+    t_std_error rc = _nas_npu_add_remove_lags_to_vlan(lags, vlan_id, port_mode, add);
+    if (add && port_mode == NAS_PORT_UNTAGGED) {
+        ndi_set_lag_pvid(0, *lag_id, vlan_id);
+    }
+    return rc;
+}
+
+/*
+ * Program the vlan membership of the members collected during a memberlist
+ * update: one NDI call per NPU for the ports and one for the LAGs. If a call
+ * fails, the groups already programmed are undone and the NPU is left as it
+ * was before the update.
+ */
+t_std_error NAS_DOT1Q_BRIDGE::nas_bridge_npu_batch_flush(nas_port_mode_t port_mode, bool add)
+{
+    t_std_error rc = STD_ERR_OK;
+    std::map<npu_id_t, std::vector<ndi_port_t>> port_grps;
+    std::vector<ndi_obj_id_t> lags;
+
+    for (auto &mem : npu_batch) {
+        if (mem.int_type == nas_int_type_LAG) {
+            lags.push_back(mem.lag_id);
+        } else {
+            port_grps[mem.ndi_port.npu_id].push_back(mem.ndi_port);
+        }
+    }
+
+    auto undo_ports = [&](std::map<npu_id_t, std::vector<ndi_port_t>>::iterator end) {
+        for (auto it = port_grps.begin(); it != end; ++it) {
+            if (_nas_npu_add_remove_ports_to_vlan(it->first, it->second, bridge_vlan_id, port_mode, !add)
+                    != STD_ERR_OK) {
+                EV_LOGGING(INTERFACE,ERR,"NAS-BRIDGE","Failed to rollback %lu ports of npu %d in the Vlan %d",
+                        it->second.size(), it->first, bridge_vlan_id);
+            }
+        }
+    };
+
+    for (auto it = port_grps.begin(); it != port_grps.end(); ++it) {
+        if ((rc = _nas_npu_add_remove_ports_to_vlan(it->first, it->second, bridge_vlan_id, port_mode, add))
+                != STD_ERR_OK) {
+            EV_LOGGING(INTERFACE,ERR,"NAS-BRIDGE","Failed to %s %lu ports of npu %d to/from the Vlan %d in the NPU",
+                    (add ? "add":"delete"), it->second.size(), it->first, bridge_vlan_id);
+            // The failed call may have programmed part of its group
+            undo_ports(std::next(it));
+            return rc;
+        }
+    }
+    if (!lags.empty() &&
+        (rc = _nas_npu_add_remove_lags_to_vlan(lags, bridge_vlan_id, port_mode, add)) != STD_ERR_OK) {
+        EV_LOGGING(INTERFACE,ERR,"NAS-BRIDGE","Failed to %s %lu lags to/from the Vlan %d in the NPU",
+                (add ? "add":"delete"), lags.size(), bridge_vlan_id);
+        if (_nas_npu_add_remove_lags_to_vlan(lags, bridge_vlan_id, port_mode, !add) != STD_ERR_OK) {
+            EV_LOGGING(INTERFACE,ERR,"NAS-BRIDGE","Failed to rollback %lu lags in the Vlan %d",
+                    lags.size(), bridge_vlan_id);
+        }
+        undo_ports(port_grps.end());
+        return rc;
+    }
+
+    /*  Per member settings done after the membership by the single member path */
+    for (auto &mem : npu_batch) {
+        if (mem.int_type == nas_int_type_LAG) {
+            if (add && port_mode == NAS_PORT_UNTAGGED) {
+                ndi_set_lag_pvid(0, mem.lag_id, bridge_vlan_id);
+            }
+            nas_bridge_set_lag_tag_untag_drop(npu_id, mem.lag_id, mem.if_index);
+            if (add) {
+                nas_interface_utils_config_lag_1q_mac_learn_mode(mem.if_name, npu_id, mem.lag_id);
+            }
+        } else {
+            if (add && port_mode == NAS_PORT_UNTAGGED) {
+                ndi_set_port_vid(mem.ndi_port.npu_id, mem.ndi_port.npu_port, bridge_vlan_id);
+            }
+            nas_bridge_set_tag_untag_drop(mem.if_index, &mem.ndi_port);
+            if (add) {
+                nas_interface_utils_config_port_1q_mac_learn_mode(mem.if_name, &mem.ndi_port);
+            }
         }
-    } else {
-        rc = ndi_del_lag_from_vlan(0, vlan_id, t_list, tag_cnt, ut_list, untag_cnt);
     }
     return rc;
 }
@@ -340,7 +423,19 @@ t_std_error NAS_DOT1Q_BRIDGE::nas_bridge_npu_add_remove_member(std::string &mem_
     // call nas_intf_cleanup_l2mc_config(p_link_node->ifindex,  p_bridge->vlan_id)) if 1Q mode
 
     /*  If bridge vlan ID is 0 and set tge vlan_id to the bridge */
-    if (intf_ctrl.int_type == nas_int_type_LAG) {
+    if (npu_batch_active && vlan_id == bridge_vlan_id &&
+        ((intf_ctrl.int_type == nas_int_type_LAG) ||
+         (((intf_ctrl.int_type == nas_int_type_PORT) || (intf_ctrl.int_type == nas_int_type_FC)) &&
+          !(nas_is_virtual_port(intf_ctrl.if_index))))) {
+        /*  Programmed with the rest of the memberlist */
+        nas_1q_npu_batch_mem_t mem;
+        mem.if_name = intf_ctrl.if_name;
+        mem.if_index = intf_ctrl.if_index;
+        mem.int_type = intf_ctrl.int_type;
+        mem.ndi_port = {intf_ctrl.npu_id, intf_ctrl.port_id};
+        mem.lag_id = intf_ctrl.lag_id;
+        npu_batch.push_back(mem);
+    } else if (intf_ctrl.int_type == nas_int_type_LAG) {
         rc = _nas_npu_add_remove_lag_to_vlan(&intf_ctrl.lag_id, vlan_id, port_mode, add_member);
         if (rc == STD_ERR_OK) {
             nas_bridge_set_lag_tag_untag_drop(npu_id, intf_ctrl.lag_id, intf_ctrl.if_index);
@@ -439,6 +534,10 @@ t_std_error NAS_DOT1Q_BRIDGE::nas_bridge_add_remove_memberlist(memberlist_t & m_
 {
     t_std_error  rc = STD_ERR_OK;
     memberlist_t processed_mem_list;
+
+    /*  The NPU membership of the list is programmed in bulk once all members are processed */
+    npu_batch.clear();
+    npu_batch_active = true;
     for (auto mem : m_list) {
         if ((rc = nas_bridge_add_remove_member(mem, port_mode, add)) != STD_ERR_OK) {
             break;
@@ -446,14 +545,21 @@ t_std_error NAS_DOT1Q_BRIDGE::nas_bridge_add_remove_memberlist(memberlist_t & m_
         // Save processed member in a list
         processed_mem_list.insert(mem);
     }
+    if (rc == STD_ERR_OK) {
+        rc = nas_bridge_npu_batch_flush(port_mode, add);
+    }
+    npu_batch.clear();
     if (rc != STD_ERR_OK) {
-        // IF any failure then rollback the added or removed members
+        // IF any failure then rollback the added or removed members. Members batched so far are not
+        // programmed in the NPU, so the rollback is batched and dropped as well.
         for (auto mem : processed_mem_list) {
             if (nas_bridge_add_remove_member(mem, port_mode, !add) != STD_ERR_OK) {
                 EV_LOGGING(INTERFACE,ERR,"INT-DB-GET","Failed to rollback member %s update", mem.c_str());
             }
         }
+        npu_batch.clear();
     }
+    npu_batch_active = false;
     return rc;
 }
 t_std_error NAS_DOT1Q_BRIDGE::nas_bridge_associate_npu_port(std::string &mem_name, ndi_port_t *ndi_port, nas_port_mode_t port_mode, bool associate)
@@ -468,7 +574,7 @@ t_std_error NAS_DOT1Q_BRIDGE::nas_bridge_associate_npu_port(std::string &mem_nam
     // TODO check if mem_name exists in the member list
     rc =  _nas_npu_add_remove_port_to_vlan(ndi_port, nas_bridge_vlan_id_get(), port_mode, associate);
     if (rc == STD_ERR_OK) {
-        nas_bridge_set_tag_untag_drop(if_index, ndi_port);
+        nas_bridge_set_tag_untag_drop(if_index, ndi_port, true);
     } else {
         EV_LOGGING(INTERFACE,ERR,"NAS-BRIDGE","1Q bridge assocaite NPU port : Failed to add member %s to the Vlan %d in the NPU",
             mem_name.c_str(),bridge_vlan_id);
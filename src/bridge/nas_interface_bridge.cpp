@@ -31,6 +31,11 @@
 #include "nas_os_interface.h"
 #include "nas_ndi_lag.h"
 
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
 
 bool NAS_BRIDGE::nas_bridge_tagged_member_present(void) {
     if (tagged_members.empty()) { return false;}
@@ -599,7 +604,56 @@ t_std_error NAS_BRIDGE::nas_bridge_set_attribute(cps_api_object_t obj , cps_api_
 }
 
 
-t_std_error NAS_BRIDGE::nas_bridge_set_lag_tag_untag_drop(npu_id_t npu_id, ndi_obj_id_t lag_id ,hal_ifindex_t ifx)
+/*
+ * Tagged/untagged drop state last written to the NPU, per port and per LAG.
+ * The membership counts are kept as members come and go, so the drop
+ * attributes only need a write when a count moves between 0 and 1.
+ */
+typedef struct _nas_bridge_drop_state_t {
+    bool drop_untag;
+    bool drop_tag;
+} nas_bridge_drop_state_t;
+
+/* Keyed by NPU and NPU port or NDI LAG id, LAG ids are only unique within an NPU */
+typedef std::pair<npu_id_t, uint64_t> nas_bridge_drop_key_t;
+typedef std::map<nas_bridge_drop_key_t, nas_bridge_drop_state_t> nas_bridge_drop_tbl_t;
+
+static std::mutex _drop_state_mtx;
+static nas_bridge_drop_tbl_t _port_drop_state;
+static nas_bridge_drop_tbl_t _lag_drop_state;
+
+/* Returns the attributes that differ from the programmed state */
+static void _drop_state_diff(nas_bridge_drop_tbl_t &tbl, const nas_bridge_drop_key_t &key,
+                             bool drop_untag, bool drop_tag, bool force, bool *set_untag, bool *set_tag)
+{
+    std::lock_guard<std::mutex> l(_drop_state_mtx);
+    auto it = tbl.find(key);
+    if (force || it == tbl.end()) {
+        *set_untag = *set_tag = true;
+        return;
+    }
+    *set_untag = (it->second.drop_untag != drop_untag);
+    *set_tag = (it->second.drop_tag != drop_tag);
+}
+
+/*
+ * Record what was written. An interface that has left the master table is
+ * forgotten, so the first membership after it is re-added is always written.
+ */
+static void _drop_state_update(nas_bridge_drop_tbl_t &tbl, const nas_bridge_drop_key_t &key,
+                               bool drop_untag, bool drop_tag, bool untag_ok, bool tag_ok, bool in_master_tbl)
+{
+    std::lock_guard<std::mutex> l(_drop_state_mtx);
+    if (!in_master_tbl || !untag_ok || !tag_ok) {
+        //A failed write is retried on the next membership change
+        tbl.erase(key);
+        return;
+    }
+    tbl[key] = {drop_untag, drop_tag};
+}
+
+t_std_error NAS_BRIDGE::nas_bridge_set_lag_tag_untag_drop(npu_id_t npu_id, ndi_obj_id_t lag_id ,hal_ifindex_t ifx,
+                                                          bool force)
 {
     t_std_error rc = STD_ERR_OK;
     auto untag_tag_cnt = nas_intf_untag_tag_count(ifx);
@@ -613,6 +667,13 @@ t_std_error NAS_BRIDGE::nas_bridge_set_lag_tag_untag_drop(npu_id_t npu_id, ndi_o
         drop_tag = (untag_tag_cnt.second > 0) ? false:true;
     }
 
+    nas_bridge_drop_key_t key(npu_id, lag_id);
+    bool set_untag, set_tag;
+    _drop_state_diff(_lag_drop_state, key, drop_untag, drop_tag, force, &set_untag, &set_tag);
+    if (!set_untag && !set_tag) {
+        return STD_ERR_OK;
+    }
+
     EV_LOGGING(INTERFACE, INFO, "NAS-Port",
        "Updating packet drop for LAG ifx %d  lag <%d %llx>: untagged - %s; tagged - %s; untag-tag cnt %d: %d",
        ifx, npu_id, lag_id,
@@ -620,22 +681,32 @@ t_std_error NAS_BRIDGE::nas_bridge_set_lag_tag_untag_drop(npu_id_t npu_id, ndi_o
        drop_tag == true ? "drop" : "not drop",
        untag_tag_cnt.first, untag_tag_cnt.second);
 
-    rc = ndi_lag_set_packet_drop(npu_id, lag_id, NDI_PORT_DROP_UNTAGGED, drop_untag);
-    if (rc != STD_ERR_OK) {
-        EV_LOGGING(INTERFACE, ERR, "NAS-Port", "Failed to disable/enable untagged drop for port <%d %d>",
-                   npu_id, lag_id);
+    t_std_error untag_rc = STD_ERR_OK;
+    t_std_error tag_rc = STD_ERR_OK;
+    if (set_untag) {
+        untag_rc = ndi_lag_set_packet_drop(npu_id, lag_id, NDI_PORT_DROP_UNTAGGED, drop_untag);
+        if (untag_rc != STD_ERR_OK) {
+            EV_LOGGING(INTERFACE, ERR, "NAS-Port", "Failed to disable/enable untagged drop for port <%d %d>",
+                       npu_id, lag_id);
+            rc = untag_rc;
+        }
     }
-    rc = ndi_lag_set_packet_drop(npu_id, lag_id, NDI_PORT_DROP_TAGGED, drop_tag);
-    if (rc != STD_ERR_OK) {
-        EV_LOGGING(INTERFACE, ERR, "NAS-Port", "Failed to disable/enable tagged drop for port <%d %d>",
-                   npu_id, lag_id);
+    if (set_tag) {
+        tag_rc = ndi_lag_set_packet_drop(npu_id, lag_id, NDI_PORT_DROP_TAGGED, drop_tag);
+        if (tag_rc != STD_ERR_OK) {
+            EV_LOGGING(INTERFACE, ERR, "NAS-Port", "Failed to disable/enable tagged drop for port <%d %d>",
+                       npu_id, lag_id);
+            rc = tag_rc;
+        }
     }
+    _drop_state_update(_lag_drop_state, key, drop_untag, drop_tag,
+                       untag_rc == STD_ERR_OK, tag_rc == STD_ERR_OK, untag_tag_cnt.first != -1);
     return rc;
 
 
 }
 
-t_std_error NAS_BRIDGE::nas_bridge_set_tag_untag_drop(hal_ifindex_t ifx, ndi_port_t *port)
+t_std_error NAS_BRIDGE::nas_bridge_set_tag_untag_drop(hal_ifindex_t ifx, ndi_port_t *port, bool force)
 {
     t_std_error rc = STD_ERR_OK;
     auto untag_tag_cnt = nas_intf_untag_tag_count(ifx);
@@ -648,6 +719,13 @@ t_std_error NAS_BRIDGE::nas_bridge_set_tag_untag_drop(hal_ifindex_t ifx, ndi_por
         drop_tag = (untag_tag_cnt.second > 0) ? false:true;
     }
 
+    nas_bridge_drop_key_t key(port->npu_id, port->npu_port);
+    bool set_untag, set_tag;
+    _drop_state_diff(_port_drop_state, key, drop_untag, drop_tag, force, &set_untag, &set_tag);
+    if (!set_untag && !set_tag) {
+        return STD_ERR_OK;
+    }
+
     EV_LOGGING(INTERFACE, INFO, "NAS-Port",
                    "Updating packet drop for ifx %d  port <%d %d>: untagged - %s; tagged - %s; untag-tag cnt %d: %d",
                    ifx, port->npu_id, port->npu_port,
@@ -655,17 +733,26 @@ t_std_error NAS_BRIDGE::nas_bridge_set_tag_untag_drop(hal_ifindex_t ifx, ndi_por
                    drop_tag == true ? "drop" : "not drop",
                     untag_tag_cnt.first, untag_tag_cnt.second);
 
-
-    rc = ndi_port_set_packet_drop(port->npu_id, port->npu_port, NDI_PORT_DROP_UNTAGGED, drop_untag);
-    if (rc != STD_ERR_OK) {
-        EV_LOGGING(INTERFACE, ERR, "NAS-Port", "Failed to disable/enable untagged drop for port <%d %d>",
-                   port->npu_id, port->npu_port);
+    t_std_error untag_rc = STD_ERR_OK;
+    t_std_error tag_rc = STD_ERR_OK;
+    if (set_untag) {
+        untag_rc = ndi_port_set_packet_drop(port->npu_id, port->npu_port, NDI_PORT_DROP_UNTAGGED, drop_untag);
+        if (untag_rc != STD_ERR_OK) {
+            EV_LOGGING(INTERFACE, ERR, "NAS-Port", "Failed to disable/enable untagged drop for port <%d %d>",
+                       port->npu_id, port->npu_port);
+            rc = untag_rc;
+        }
     }
-    rc = ndi_port_set_packet_drop(port->npu_id, port->npu_port, NDI_PORT_DROP_TAGGED, drop_tag);
-    if (rc != STD_ERR_OK) {
-        EV_LOGGING(INTERFACE, ERR, "NAS-Port", "Failed to disable/enable tagged drop for port <%d %d>",
-                    port->npu_id, port->npu_port);
+    if (set_tag) {
+        tag_rc = ndi_port_set_packet_drop(port->npu_id, port->npu_port, NDI_PORT_DROP_TAGGED, drop_tag);
+        if (tag_rc != STD_ERR_OK) {
+            EV_LOGGING(INTERFACE, ERR, "NAS-Port", "Failed to disable/enable tagged drop for port <%d %d>",
+                        port->npu_id, port->npu_port);
+            rc = tag_rc;
+        }
     }
+    _drop_state_update(_port_drop_state, key, drop_untag, drop_tag,
+                       untag_rc == STD_ERR_OK, tag_rc == STD_ERR_OK, untag_tag_cnt.first != -1);
     return rc;
 
 
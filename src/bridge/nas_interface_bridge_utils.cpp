@@ -1214,19 +1214,8 @@ static t_std_error nas_bridge_utils_set_remote_endpoint_attr(NAS_VXLAN_INTERFACE
     return STD_ERR_OK;
 }
 
-/*  Add remote endpoint to a vxlan interface */
-
-t_std_error nas_bridge_utils_add_remote_endpoint(const char *vxlan_intf_name,remote_endpoint_t & rem_ep) {
-    /*TODO  Add vxlan lock    */
+static t_std_error _nas_bridge_utils_add_remote_endpoint(NAS_VXLAN_INTERFACE *vxlan_obj, remote_endpoint_t & rem_ep) {
     t_std_error rc = STD_ERR(INTERFACE, FAIL, 0);
-    /*  Get vxlan_obj from name  */
-    std::string _if_name = std::string(vxlan_intf_name);
-    NAS_VXLAN_INTERFACE *vxlan_obj = (NAS_VXLAN_INTERFACE *)nas_interface_map_obj_get(_if_name);
-    if (vxlan_obj == nullptr) {
-        EV_LOGGING(INTERFACE,ERR,"NAS-BRIDGE", " Bridge mmber addition failed ");
-        return rc;
-    }
-
 
     /*  Add the remote endpoint to the vxlan */
     /*  Check if vxlan has 1d bridge associated */
@@ -1354,19 +1343,11 @@ t_std_error nas_bridge_utils_update_remote_endpoint(const char *vxlan_intf_name,
     return STD_ERR_OK;
 }
 
-/*  remove a remote endpoint from a vxlan interface */
-t_std_error nas_bridge_utils_remove_remote_endpoint(const char *vxlan_intf_name, remote_endpoint_t & rem_ep)
+static t_std_error _nas_bridge_utils_remove_remote_endpoint(NAS_VXLAN_INTERFACE *vxlan_obj, remote_endpoint_t & rem_ep)
 {
-    /*TODO  Add vxlan lock    */
     t_std_error rc = STD_ERR(INTERFACE, FAIL, 0);
-    /*  Get vxlan_obj from name  */
-    std::string _if_name = std::string(vxlan_intf_name);
-    NAS_VXLAN_INTERFACE *vxlan_obj = (NAS_VXLAN_INTERFACE *)nas_interface_map_obj_get(_if_name);
-
-    if (vxlan_obj == nullptr) {
-        EV_LOGGING(INTERFACE,ERR,"NAS-BRIDGE", " Remote endpoint removal failed:  vxlan interface %s not found",vxlan_intf_name);
-        return rc;
-    }
+    std::string _if_name = vxlan_obj->get_ifname();
+    const char *vxlan_intf_name = _if_name.c_str();
 
     char buff[HAL_INET6_TEXT_LEN + 1];
     std_ip_to_string((const hal_ip_addr_t*) &rem_ep.remote_ip, buff, HAL_INET6_TEXT_LEN);
@@ -1432,6 +1413,69 @@ t_std_error nas_bridge_utils_remove_remote_endpoint(const char *vxlan_intf_name,
     return STD_ERR_OK;
 }
 
+static NAS_VXLAN_INTERFACE *_nas_bridge_utils_vxlan_obj_get(const char *vxlan_intf_name)
+{
+    NAS_VXLAN_INTERFACE *vxlan_obj = (NAS_VXLAN_INTERFACE *)nas_interface_map_obj_get(std::string(vxlan_intf_name));
+    if (vxlan_obj == nullptr) {
+        EV_LOGGING(INTERFACE,ERR,"NAS-BRIDGE", " Remote endpoint update failed:  vxlan interface %s not found",
+                   vxlan_intf_name);
+    }
+    return vxlan_obj;
+}
+
+/*  Add remote endpoint to a vxlan interface */
+t_std_error nas_bridge_utils_add_remote_endpoint(const char *vxlan_intf_name,remote_endpoint_t & rem_ep) {
+    /*TODO  Add vxlan lock    */
+    NAS_VXLAN_INTERFACE *vxlan_obj = _nas_bridge_utils_vxlan_obj_get(vxlan_intf_name);
+    if (vxlan_obj == nullptr) {
+        return STD_ERR(INTERFACE, FAIL, 0);
+    }
+    return _nas_bridge_utils_add_remote_endpoint(vxlan_obj, rem_ep);
+}
+
+/*  remove a remote endpoint from a vxlan interface */
+t_std_error nas_bridge_utils_remove_remote_endpoint(const char *vxlan_intf_name, remote_endpoint_t & rem_ep)
+{
+    /*TODO  Add vxlan lock    */
+    NAS_VXLAN_INTERFACE *vxlan_obj = _nas_bridge_utils_vxlan_obj_get(vxlan_intf_name);
+    if (vxlan_obj == nullptr) {
+        return STD_ERR(INTERFACE, FAIL, 0);
+    }
+    return _nas_bridge_utils_remove_remote_endpoint(vxlan_obj, rem_ep);
+}
+
+/*  Add a list of remote endpoints to a vxlan interface, stops at the first failure */
+t_std_error nas_bridge_utils_add_remote_endpoints(const char *vxlan_intf_name, std::list<remote_endpoint_t> & rem_eps)
+{
+    t_std_error rc = STD_ERR_OK;
+    NAS_VXLAN_INTERFACE *vxlan_obj = _nas_bridge_utils_vxlan_obj_get(vxlan_intf_name);
+    if (vxlan_obj == nullptr) {
+        return STD_ERR(INTERFACE, FAIL, 0);
+    }
+    for (auto &rem_ep : rem_eps) {
+        if ((rc = _nas_bridge_utils_add_remote_endpoint(vxlan_obj, rem_ep)) != STD_ERR_OK) {
+            return rc;
+        }
+    }
+    return STD_ERR_OK;
+}
+
+/*  Remove a list of remote endpoints from a vxlan interface, stops at the first failure */
+t_std_error nas_bridge_utils_remove_remote_endpoints(const char *vxlan_intf_name, std::list<remote_endpoint_t> & rem_eps)
+{
+    t_std_error rc = STD_ERR_OK;
+    NAS_VXLAN_INTERFACE *vxlan_obj = _nas_bridge_utils_vxlan_obj_get(vxlan_intf_name);
+    if (vxlan_obj == nullptr) {
+        return STD_ERR(INTERFACE, FAIL, 0);
+    }
+    for (auto &rem_ep : rem_eps) {
+        if ((rc = _nas_bridge_utils_remove_remote_endpoint(vxlan_obj, rem_ep)) != STD_ERR_OK) {
+            return rc;
+        }
+    }
+    return STD_ERR_OK;
+}
+
 // Publish bridge create/delete event with bridge name, bridge mode and operation type.
 void nas_bridge_utils_publish_event(const char * bridge_name, cps_api_operation_types_t op)
 {
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_interface_os_batch.cpp
+ *
+ * VLAN sub interface create/delete for a whole list: all the RTM_NEWLINK or
+ * RTM_DELLINK requests are packed in one buffer and sent together, then the
+ * acks are matched back to the requests by sequence number.
+ */
+
+#include "interface/nas_interface_os_batch.h"
+#include "event_log.h"
+
+#include <atomic>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_link.h>
+
+#define NAS_OS_BATCH_MSG_SZ         512
+#define NAS_OS_BATCH_RCV_BUF_SZ     (32*1024)
+#define NAS_OS_BATCH_TIMEOUT_S      2
+/* Acks of one send must fit in the socket receive buffer, larger lists go in several sends */
+#define NAS_OS_BATCH_MAX_MSGS       64
+
+struct nas_os_nl_msg_t {
+    struct nlmsghdr nh;
+    struct ifinfomsg ifi;
+    char attrs[NAS_OS_BATCH_MSG_SZ];
+};
+
+static struct rtattr *nas_os_nl_attr_add(struct nlmsghdr *nh, unsigned short type,
+                                         const void *data, size_t len) {
+    size_t rta_len = RTA_LENGTH(len);
+    if (NLMSG_ALIGN(nh->nlmsg_len) + RTA_ALIGN(rta_len) > sizeof(nas_os_nl_msg_t)) {
+        return nullptr;
+    }
+    struct rtattr *rta = (struct rtattr *)(((char *)nh) + NLMSG_ALIGN(nh->nlmsg_len));
+    rta->rta_type = type;
+    rta->rta_len = rta_len;
+    if (len != 0) memcpy(RTA_DATA(rta), data, len);
+    nh->nlmsg_len = NLMSG_ALIGN(nh->nlmsg_len) + RTA_ALIGN(rta_len);
+    return rta;
+}
+
+static inline void nas_os_nl_nest_end(struct nlmsghdr *nh, struct rtattr *nest) {
+    nest->rta_len = (((char *)nh) + nh->nlmsg_len) - (char *)nest;
+}
+
+static void nas_os_nl_msg_init(nas_os_nl_msg_t &msg, unsigned short type, unsigned short flags,
+                               uint32_t seq) {
+    memset(&msg, 0, sizeof(msg));
+    msg.nh.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    msg.nh.nlmsg_type = type;
+    msg.nh.nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK | flags;
+    msg.nh.nlmsg_seq = seq;
+    msg.ifi.ifi_family = AF_UNSPEC;
+}
+
+static bool nas_os_nl_newlink_build(nas_os_nl_msg_t &msg, const nas_os_subintf_req_t &req,
+                                    uint32_t parent_idx, uint32_t seq) {
+    nas_os_nl_msg_init(msg, RTM_NEWLINK, NLM_F_CREATE | NLM_F_EXCL, seq);
+    msg.ifi.ifi_flags = IFF_UP;
+    msg.ifi.ifi_change = IFF_UP;
+
+    uint16_t vlan_id = req.vlan_id;
+    struct nlmsghdr *nh = &msg.nh;
+    if (nas_os_nl_attr_add(nh, IFLA_LINK, &parent_idx, sizeof(parent_idx)) == nullptr ||
+        nas_os_nl_attr_add(nh, IFLA_IFNAME, req.if_name.c_str(), req.if_name.size() + 1) == nullptr) {
+        return false;
+    }
+    /* Set the MTU at creation so no per interface RTM_SETLINK follows the batch */
+    if (req.mtu != 0 && nas_os_nl_attr_add(nh, IFLA_MTU, &req.mtu, sizeof(req.mtu)) == nullptr) {
+        return false;
+    }
+    struct rtattr *linkinfo = nas_os_nl_attr_add(nh, IFLA_LINKINFO, nullptr, 0);
+    if (linkinfo == nullptr ||
+        nas_os_nl_attr_add(nh, IFLA_INFO_KIND, "vlan", strlen("vlan")) == nullptr) {
+        return false;
+    }
+    struct rtattr *info_data = nas_os_nl_attr_add(nh, IFLA_INFO_DATA, nullptr, 0);
+    if (info_data == nullptr ||
+        nas_os_nl_attr_add(nh, IFLA_VLAN_ID, &vlan_id, sizeof(vlan_id)) == nullptr) {
+        return false;
+    }
+    nas_os_nl_nest_end(nh, info_data);
+    nas_os_nl_nest_end(nh, linkinfo);
+    return true;
+}
+
+static int nas_os_nl_sock_open(void) {
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0) {
+        EV_LOGGING(INTERFACE, ERR, "NAS-OS-BATCH", "Failed to open netlink socket %d", errno);
+        return -1;
+    }
+    struct sockaddr_nl sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.nl_family = AF_NETLINK;
+
+    struct timeval tv = { NAS_OS_BATCH_TIMEOUT_S, 0 };
+    if (bind(fd, (struct sockaddr *)&sa, sizeof(sa)) < 0 ||
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) < 0) {
+        EV_LOGGING(INTERFACE, ERR, "NAS-OS-BATCH", "Failed to set up netlink socket %d", errno);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/*
+ * Send the messages built for reqs[first, last) as one buffer and wait for their acks.
+ * The seq of a message is base_seq plus the index of its request.
+ */
+static void nas_os_nl_batch_send(int fd, const std::vector<char> &buf, nas_os_subintf_req_list_t &reqs,
+                                 std::vector<bool> &sent, size_t first, size_t last,
+                                 uint32_t base_seq, size_t pending) {
+    if (pending == 0) return;
+
+    if (send(fd, buf.data(), buf.size(), 0) < 0) {
+        EV_LOGGING(INTERFACE, ERR, "NAS-OS-BATCH", "Failed to send %zu netlink requests %d",
+                   pending, errno);
+        return;
+    }
+
+    static thread_local char rcv_buf[NAS_OS_BATCH_RCV_BUF_SZ] __attribute__((aligned(NLMSG_ALIGNTO)));
+    while (pending > 0) {
+        ssize_t len = recv(fd, rcv_buf, sizeof(rcv_buf), 0);
+        if (len < 0) {
+            if (errno == EINTR) continue;
+            EV_LOGGING(INTERFACE, ERR, "NAS-OS-BATCH", "No ack for %zu netlink requests %d",
+                       pending, errno);
+            return;
+        }
+        int msg_len = (int)len;
+        for (struct nlmsghdr *nh = (struct nlmsghdr *)rcv_buf; NLMSG_OK(nh, msg_len);
+             nh = NLMSG_NEXT(nh, msg_len)) {
+            if (nh->nlmsg_type != NLMSG_ERROR) continue;
+            size_t ix = nh->nlmsg_seq - base_seq;
+            if (ix < first || ix >= last || !sent[ix]) continue;
+            sent[ix] = false;
+
+            struct nlmsgerr *err = (struct nlmsgerr *)NLMSG_DATA(nh);
+            if (err->error == 0) {
+                reqs[ix].rc = STD_ERR_OK;
+            } else {
+                EV_LOGGING(INTERFACE, ERR, "NAS-OS-BATCH", "Kernel failed request for %s: %s",
+                           reqs[ix].if_name.c_str(), strerror(-err->error));
+            }
+            --pending;
+        }
+    }
+}
+
+static std::atomic<uint32_t> _nl_seq(0);
+
+static t_std_error nas_os_subintf_batch_run(nas_os_subintf_req_list_t &reqs, bool create) {
+    if (reqs.empty()) return STD_ERR_OK;
+
+    int fd = nas_os_nl_sock_open();
+    if (fd < 0) return STD_ERR(INTERFACE, FAIL, 0);
+
+    uint32_t base_seq = _nl_seq.fetch_add(reqs.size());
+
+    std::vector<bool> sent(reqs.size(), false);
+    std::vector<char> buf;
+    buf.reserve(NAS_OS_BATCH_MAX_MSGS * NLMSG_ALIGN(sizeof(nas_os_nl_msg_t)));
+    size_t pending = 0;
+    size_t first = 0;
+    nas_os_nl_msg_t msg;
+
+    for (size_t ix = 0; ix < reqs.size(); ++ix) {
+        nas_os_subintf_req_t &req = reqs[ix];
+        req.rc = STD_ERR(INTERFACE, FAIL, 0);
+        uint32_t seq = base_seq + ix;
+
+        if (create) {
+            uint32_t parent_idx = if_nametoindex(req.parent_name.c_str());
+            if (parent_idx == 0) {
+                EV_LOGGING(INTERFACE, ERR, "NAS-OS-BATCH", "No kernel parent %s for sub interface %s",
+                           req.parent_name.c_str(), req.if_name.c_str());
+                continue;
+            }
+            if (!nas_os_nl_newlink_build(msg, req, parent_idx, seq)) {
+                EV_LOGGING(INTERFACE, ERR, "NAS-OS-BATCH", "Failed to build request for %s",
+                           req.if_name.c_str());
+                continue;
+            }
+        } else {
+            nas_os_nl_msg_init(msg, RTM_DELLINK, 0, seq);
+            msg.ifi.ifi_index = req.if_index;
+        }
+
+        const char *p = (const char *)&msg;
+        buf.insert(buf.end(), p, p + NLMSG_ALIGN(msg.nh.nlmsg_len));
+        sent[ix] = true;
+
+        if (++pending == NAS_OS_BATCH_MAX_MSGS) {
+            nas_os_nl_batch_send(fd, buf, reqs, sent, first, ix + 1, base_seq, pending);
+            buf.clear();
+            pending = 0;
+            first = ix + 1;
+        }
+    }
+    nas_os_nl_batch_send(fd, buf, reqs, sent, first, reqs.size(), base_seq, pending);
+    close(fd);
+
+    t_std_error rc = STD_ERR_OK;
+    for (auto &req : reqs) {
+        if (req.rc != STD_ERR_OK) {
+            rc = STD_ERR(INTERFACE, FAIL, 0);
+            continue;
+        }
+        if (create) {
+            req.if_index = if_nametoindex(req.if_name.c_str());
+            if (req.if_index == 0) {
+                EV_LOGGING(INTERFACE, ERR, "NAS-OS-BATCH", "Sub interface %s not found after create",
+                           req.if_name.c_str());
+                req.rc = STD_ERR(INTERFACE, FAIL, 0);
+                rc = req.rc;
+            }
+        }
+    }
+    return rc;
+}
+
+t_std_error nas_os_subintf_batch_create(nas_os_subintf_req_list_t &reqs) {
+    return nas_os_subintf_batch_run(reqs, true);
+}
+
+t_std_error nas_os_subintf_batch_delete(nas_os_subintf_req_list_t &reqs) {
+    return nas_os_subintf_batch_run(reqs, false);
+}
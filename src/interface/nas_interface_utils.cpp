@@ -28,6 +28,7 @@
 #include "hal_if_mapping.h"
 #include "nas_os_interface.h"
 #include "interface/nas_interface_mgmt.h"
+#include "interface/nas_interface_os_batch.h"
 #include <std_utils.h>
 
 void nas_interface_cps_publish_event(std::string &if_name, nas_int_type_t if_type, cps_api_operation_types_t op)
@@ -529,20 +530,11 @@ t_std_error nas_interface_subintf_create(std::string &intf_name, hal_vlan_id_t v
     return STD_ERR_OK;
 }
 
-t_std_error nas_interface_vlan_subintf_create(std::string &intf_name, hal_vlan_id_t vlan_id, std::string &parent, bool in_os)
+/* Add a sub interface to the cache, registering it first if it already exists in the kernel */
+static t_std_error nas_interface_vlan_subintf_cache_add(std::string &intf_name, hal_vlan_id_t vlan_id,
+                                                        std::string &parent, hal_ifindex_t if_index)
 {
-    NAS_INTERFACE *intf_obj = nas_interface_map_obj_get(intf_name);
-    if (intf_obj != nullptr) {
-        EV_LOGGING(INTERFACE,ERR, "NAS-INTF", " Failed to add interface %s: Already present ",
-                                intf_name.c_str());
-        return STD_ERR(INTERFACE, FAIL, 0);
-    }
-    hal_ifindex_t if_index =NAS_IF_INDEX_INVALID;
-    if (in_os) {
-        if (nas_interface_utils_os_vlan_intf_create_delete(intf_name.c_str(), vlan_id, parent.c_str(),
-                                                    cps_api_oper_CREATE, &if_index) != STD_ERR_OK) {
-            return STD_ERR(INTERFACE, FAIL, 0);
-        }
+    if (if_index != NAS_IF_INDEX_INVALID) {
         /*  register only if  created in the kernel since if_index is used as a key */
         if(!nas_intf_cntrl_blk_register(if_index,intf_name,nas_int_type_VLANSUB_INTF,true)){
             EV_LOGGING(INTERFACE,ERR,"NAS-VLAN-SUB-INTF","Failed to register the vlan sub interface %s",
@@ -561,6 +553,24 @@ t_std_error nas_interface_vlan_subintf_create(std::string &intf_name, hal_vlan_i
     return STD_ERR_OK;
 }
 
+t_std_error nas_interface_vlan_subintf_create(std::string &intf_name, hal_vlan_id_t vlan_id, std::string &parent, bool in_os)
+{
+    NAS_INTERFACE *intf_obj = nas_interface_map_obj_get(intf_name);
+    if (intf_obj != nullptr) {
+        EV_LOGGING(INTERFACE,ERR, "NAS-INTF", " Failed to add interface %s: Already present ",
+                                intf_name.c_str());
+        return STD_ERR(INTERFACE, FAIL, 0);
+    }
+    hal_ifindex_t if_index =NAS_IF_INDEX_INVALID;
+    if (in_os) {
+        if (nas_interface_utils_os_vlan_intf_create_delete(intf_name.c_str(), vlan_id, parent.c_str(),
+                                                    cps_api_oper_CREATE, &if_index) != STD_ERR_OK) {
+            return STD_ERR(INTERFACE, FAIL, 0);
+        }
+    }
+    return nas_interface_vlan_subintf_cache_add(intf_name, vlan_id, parent, if_index);
+}
+
 t_std_error nas_interface_os_vlan_subintf_create(std::string &intf_name, hal_vlan_id_t vlan_id)
 {
     NAS_VLAN_INTERFACE *vlan_obj = dynamic_cast<NAS_VLAN_INTERFACE *> (nas_interface_map_obj_get(intf_name));
@@ -588,15 +598,49 @@ t_std_error nas_interface_os_vlan_subintf_create(std::string &intf_name, hal_vla
     return STD_ERR_OK;
 }
 
+/* Register the sub interfaces created in the kernel by a batch and store their if-index */
+static void nas_interface_os_subintf_batch_commit(nas_os_subintf_req_list_t &reqs)
+{
+    for (auto &req : reqs) {
+        if (req.rc != STD_ERR_OK) continue;
+
+        NAS_VLAN_INTERFACE *vlan_obj = dynamic_cast<NAS_VLAN_INTERFACE *> (nas_interface_map_obj_get(req.if_name));
+        if (vlan_obj == nullptr) continue;
+
+        if(!nas_intf_cntrl_blk_register(req.if_index,req.if_name,nas_int_type_VLANSUB_INTF,true)){
+            EV_LOGGING(INTERFACE,ERR,"NAS-VLAN-SUB-INTF","Failed to register the vlan sub interface %s",
+                        req.if_name.c_str());
+            continue;
+        }
+        vlan_obj->set_ifindex(req.if_index);
+    }
+}
+
 t_std_error nas_interface_os_vlan_subintf_list_create(intf_list_t & intf_list, hal_vlan_id_t vlan_id)
 
 {
     std_mutex_simple_lock_guard lock(get_vlan_mutex());
-    for (auto intf_name : intf_list ) {
+    nas_os_subintf_req_list_t reqs;
+    reqs.reserve(intf_list.size());
+    for (auto &intf_name : intf_list ) {
 
         EV_LOGGING(INTERFACE,DEBUG, "NAS-INTF", " Create sub interface %s", intf_name.c_str());
-        nas_interface_os_vlan_subintf_create(intf_name,vlan_id);
+        NAS_VLAN_INTERFACE *vlan_obj = dynamic_cast<NAS_VLAN_INTERFACE *> (nas_interface_map_obj_get(intf_name));
+        if (vlan_obj == nullptr) {
+            EV_LOGGING(INTERFACE,ERR, "NAS-INTF", " Failed to get interface %s: ",
+                                    intf_name.c_str());
+            continue;
+        }
+        if (vlan_obj->get_ifindex() != NAS_IF_INDEX_INVALID) {
+            EV_LOGGING(INTERFACE,DEBUG, "NAS-INTF", " Sub intf is already created in kernel %s", intf_name.c_str());
+            continue;
+        }
+        reqs.emplace_back(intf_name, vlan_obj->parent_name_get(), vlan_id, NAS_IF_INDEX_INVALID,
+                          vlan_obj->get_mtu());
     }
+    /* All the sub interfaces go to the kernel in one netlink send, failures are logged per interface */
+    nas_os_subintf_batch_create(reqs);
+    nas_interface_os_subintf_batch_commit(reqs);
     return STD_ERR_OK;
 }
 
@@ -605,7 +649,9 @@ t_std_error nas_interface_create_subintfs(intf_list_t &intf_list)
 {
 
    std_mutex_simple_lock_guard lock(get_vlan_mutex());
-   for (auto  intf_name : intf_list ) {
+   nas_os_subintf_req_list_t reqs;
+   reqs.reserve(intf_list.size());
+   for (auto  &intf_name : intf_list ) {
        NAS_INTERFACE *intf_obj = nas_interface_map_obj_get(intf_name);
        if (intf_obj == nullptr ) {
            EV_LOGGING(INTERFACE,ERR, "NAS-INTF", " Sub intf doesn't exist in cache ",
@@ -619,16 +665,16 @@ t_std_error nas_interface_create_subintfs(intf_list_t &intf_list)
            return STD_ERR(INTERFACE, FAIL, 0);
        }
        if (vlan_obj->get_ifindex() != NAS_IF_INDEX_INVALID) {
-           EV_LOGGING(INTERFACE,ERR, "NAS-INTF", " Sub intf is already created %s", intf_name.c_str());
-           return STD_ERR(INTERFACE, FAIL, 0);
+           EV_LOGGING(INTERFACE,DEBUG, "NAS-INTF", " Sub intf is already created in kernel %s", intf_name.c_str());
+           continue;
 
        }
-       std::string parent = vlan_obj->parent_name_get();
-       hal_vlan_id_t vlan_id = vlan_obj->vlan_id_get();
-       hal_ifindex_t idx = NAS_IF_INDEX_INVALID;
-       nas_interface_subintf_create(intf_name, vlan_id, parent, idx, intf_obj);
+       reqs.emplace_back(intf_name, vlan_obj->parent_name_get(), vlan_obj->vlan_id_get(), NAS_IF_INDEX_INVALID,
+                         vlan_obj->get_mtu());
    }
 
+   nas_os_subintf_batch_create(reqs);
+   nas_interface_os_subintf_batch_commit(reqs);
     return STD_ERR_OK;
 }
 
@@ -638,7 +684,9 @@ t_std_error nas_interface_delete_subintfs(intf_list_t &intf_list)
 {
 
    std_mutex_simple_lock_guard lock(get_vlan_mutex());
-   for (auto  intf_name : intf_list ) {
+   nas_os_subintf_req_list_t reqs;
+   reqs.reserve(intf_list.size());
+   for (auto  &intf_name : intf_list ) {
        NAS_INTERFACE *intf_obj = nas_interface_map_obj_get(intf_name);
        if (intf_obj == nullptr ) {
            EV_LOGGING(INTERFACE,ERR, "NAS-INTF", " Sub intf doesn't exist in cache ",
@@ -646,19 +694,32 @@ t_std_error nas_interface_delete_subintfs(intf_list_t &intf_list)
            return STD_ERR(INTERFACE, FAIL, 0);
        }
        NAS_VLAN_INTERFACE *vlan_obj =  dynamic_cast<NAS_VLAN_INTERFACE *>(intf_obj);
-       if (intf_obj == nullptr ) {
+       if (vlan_obj == nullptr ) {
            EV_LOGGING(INTERFACE,ERR, "NAS-INTF", " Sub intf doesn't exist in cache ",
                                     intf_name.c_str());
            return STD_ERR(INTERFACE, FAIL, 0);
        }
        if (vlan_obj->get_ifindex() == NAS_IF_INDEX_INVALID) {
            EV_LOGGING(INTERFACE,DEBUG, "NAS-INTF", " Sub intf is already deleted in kernel %s", intf_name.c_str());
-           return STD_ERR_OK;
+           continue;
 
        }
-       std::string parent = vlan_obj->parent_name_get();
-       hal_vlan_id_t vlan_id = vlan_obj->vlan_id_get();
-       nas_interface_os_subintf_delete(intf_name, vlan_id, parent, vlan_obj);
+       reqs.emplace_back(intf_name, vlan_obj->parent_name_get(), vlan_obj->vlan_id_get(), vlan_obj->get_ifindex());
+   }
+
+   nas_os_subintf_batch_delete(reqs);
+   for (auto &req : reqs) {
+       if (req.rc != STD_ERR_OK) {
+           EV_LOGGING(INTERFACE,ERR,"NAS-VLAN-SUB-INTF", "Failed to delete sub intf in kernel %s",
+                      req.if_name.c_str());
+           continue;
+       }
+       NAS_INTERFACE *intf_obj = nas_interface_map_obj_get(req.if_name);
+       if (intf_obj != nullptr) intf_obj->set_ifindex(NAS_IF_INDEX_INVALID);
+       if(!nas_intf_cntrl_blk_register(req.if_index,req.if_name,nas_int_type_VLANSUB_INTF,false)){
+           EV_LOGGING(INTERFACE,ERR,"NAS-VLAN-SUB-INTF","Failed to de-register the vlan sub interface %s",
+                       req.if_name.c_str());
+       }
    }
    return STD_ERR_OK;
 
@@ -668,31 +729,45 @@ t_std_error nas_interface_delete_subintfs(intf_list_t &intf_list)
 t_std_error nas_interface_vlan_subintf_list_create(intf_list_t & intf_list, hal_vlan_id_t vlan_id, bool in_os)
 {
     std_mutex_simple_lock_guard lock(get_vlan_mutex());
-    for (auto  intf_name : intf_list ) {
+    nas_os_subintf_req_list_t reqs;
+    reqs.reserve(intf_list.size());
+    for (auto  &name : intf_list ) {
 
-        NAS_INTERFACE *intf_obj = nas_interface_map_obj_get(intf_name);
+        NAS_INTERFACE *intf_obj = nas_interface_map_obj_get(name);
         if (intf_obj != nullptr) {
             EV_LOGGING(INTERFACE,ERR, "NAS-INTF", " Failed to add interface %s: Already present ",
-                                    intf_name.c_str());
+                                    name.c_str());
             // Just continue
             continue;
         }
-        char _intf_name[HAL_IF_NAME_SZ];
-        memset(_intf_name, 0, sizeof(_intf_name));
-        char * saveptr;
-        safestrncpy(_intf_name, intf_name.c_str(), sizeof(_intf_name));
-
-        const char *_parent = strtok_r(_intf_name,".",&saveptr);
+        /* Parent is the part of the name before the first '.' */
+        std::string intf_name = name;
         std::string parent;
-        if(_parent != nullptr){
-            parent = std::string(_parent);
+        if (!name.empty()) {
+            parent = name.substr(0, name.find('.'));
         }else{
-            parent = intf_name;
-            intf_name = intf_name + "." + std::to_string(vlan_id);
+            parent = name;
+            intf_name = name + "." + std::to_string(vlan_id);
         }
         EV_LOGGING(INTERFACE,DEBUG, "NAS-INTF", " Create sub interface with parent %s", parent.c_str());
 
-        nas_interface_vlan_subintf_create(intf_name,vlan_id,parent,in_os);
+        if (!in_os) {
+            nas_interface_vlan_subintf_create(intf_name,vlan_id,parent,in_os);
+            continue;
+        }
+        reqs.emplace_back(intf_name, parent, vlan_id, NAS_IF_INDEX_INVALID);
+    }
+    if (reqs.empty()) return STD_ERR_OK;
+
+    /* Create all of them in the kernel with one netlink send, then add the ones that made it */
+    nas_os_subintf_batch_create(reqs);
+    for (auto &req : reqs) {
+        if (req.rc != STD_ERR_OK) {
+            EV_LOGGING(INTERFACE,ERR, "NAS-INTF", " Failed to add interface %s in the kernel ",
+                                req.if_name.c_str());
+            continue;
+        }
+        nas_interface_vlan_subintf_cache_add(req.if_name, req.vlan_id, req.parent_name, req.if_index);
     }
     return STD_ERR_OK;
 }
@@ -746,6 +821,50 @@ t_std_error nas_interface_vlan_subintf_list_delete(intf_list_t &list) {
     return STD_ERR_OK;
 }
 
+/* NDI port or LAG a sub interface parent maps to */
+typedef struct {
+    npu_id_t npu_id;
+    ndi_obj_id_t ndi_obj_id;
+    ndi_port_type_t ndi_port_type;
+} nas_sub_intf_parent_ndi_t;
+
+static t_std_error nas_interface_utils_sub_intf_parent_get(const std::string & parent_intf,
+                                                           nas_sub_intf_parent_ndi_t & parent){
+    interface_ctrl_t intf_entry;
+    memset(&intf_entry,0,sizeof(intf_entry));
+    intf_entry.q_type = HAL_INTF_INFO_FROM_IF_NAME;
+    safestrncpy(intf_entry.if_name,parent_intf.c_str(),sizeof(intf_entry.if_name));
+
+    t_std_error rc = STD_ERR_OK;
+    if((rc = dn_hal_get_interface_info(&intf_entry))!=STD_ERR_OK){
+        return rc;
+    }
+
+    parent.npu_id = intf_entry.npu_id;
+    parent.ndi_port_type = ndi_port_type_PORT;
+    parent.ndi_obj_id = 0;
+    if(intf_entry.int_type == nas_int_type_PORT){
+        parent.ndi_port_type = ndi_port_type_PORT;
+        parent.ndi_obj_id = intf_entry.port_id;
+    }else if(intf_entry.int_type == nas_int_type_LAG){
+        parent.ndi_port_type = ndi_port_type_LAG;
+        parent.ndi_obj_id = intf_entry.lag_id;
+    }else{
+        EV_LOGGING(INTERFACE,ERR,"SUB-INTF-ATTR-SET","Invalid Interface type %d",intf_entry.int_type);
+    }
+    return STD_ERR_OK;
+}
+
+/* Set all the attributes on one sub interface with a single NDI call, parent already resolved */
+static t_std_error nas_interface_utils_sub_intf_attrs_set(NAS_VLAN_INTERFACE *vlan_obj,
+                                                          const nas_sub_intf_parent_ndi_t & parent,
+                                                          nas_com_id_value_t val[], size_t len){
+    EV_LOGGING(INTERFACE,INFO,"SUB-INTF-ATTR-SET","Setting %lu attrs (first %lu) in npu for "
+                "interface %s",len,val[0].attr_id,vlan_obj->get_ifname().c_str());
+    return ndi_bridge_sub_port_attr_set(parent.npu_id,parent.ndi_obj_id,parent.ndi_port_type,
+                                        vlan_obj->vlan_id_get(),val,len);
+}
+
 static auto sub_intf_attr_fn = [](const std::string & intf_name, nas_com_id_value_t & val) -> t_std_error {
 
     NAS_VLAN_INTERFACE *vlan_obj = dynamic_cast<NAS_VLAN_INTERFACE *> (nas_interface_map_obj_get(intf_name));
@@ -760,43 +879,35 @@ static auto sub_intf_attr_fn = [](const std::string & intf_name, nas_com_id_valu
         return STD_ERR_OK;
     }
 
-    interface_ctrl_t intf_entry;
-    memset(&intf_entry,0,sizeof(intf_entry));
-    intf_entry.q_type = HAL_INTF_INFO_FROM_IF_NAME;
-    std::string parent_intf = vlan_obj->parent_name_get();
-    memcpy(intf_entry.if_name,parent_intf.c_str(),sizeof(intf_entry.if_name));
-
+    nas_sub_intf_parent_ndi_t parent;
     t_std_error rc = STD_ERR_OK;
-    if((rc = dn_hal_get_interface_info(&intf_entry))!=STD_ERR_OK){
+    if((rc = nas_interface_utils_sub_intf_parent_get(vlan_obj->parent_name_get(), parent))!=STD_ERR_OK){
         return rc;
     }
 
-    ndi_port_type_t ndi_port_type = ndi_port_type_PORT;
-    ndi_obj_id_t ndi_obj_id = 0;
-    if(intf_entry.int_type == nas_int_type_PORT){
-        ndi_port_type = ndi_port_type_PORT;
-        ndi_obj_id = intf_entry.port_id;
-    }else if(intf_entry.int_type == nas_int_type_LAG){
-        ndi_port_type = ndi_port_type_LAG;
-        ndi_obj_id = intf_entry.lag_id;
-    }else{
-        EV_LOGGING(INTERFACE,ERR,"SUB-INTF-ATTR-SET","Invalid Interface type %d",intf_entry.int_type);
-    }
-
-    EV_LOGGING(INTERFACE,INFO,"SUB-INTF-ATTR-SET","Setting attr %lu in npu for "
-                "interface %s",val.attr_id,intf_name.c_str());
-    return ndi_bridge_sub_port_attr_set(intf_entry.npu_id,ndi_obj_id,ndi_port_type,vlan_obj->vlan_id_get(),&val,1);
+    return nas_interface_utils_sub_intf_attrs_set(vlan_obj, parent, &val, 1);
 };
 
 t_std_error nas_interface_utils_set_vlan_subintf_attr(const std::string & intf_name,  nas_com_id_value_t  val[],
                                                       size_t len){
-    t_std_error rc = STD_ERR_OK;
-    for(size_t ix = 0 ; ix < len ; ++ix){
-        rc = sub_intf_attr_fn(intf_name,val[ix]);
-        if(rc != STD_ERR_OK) break;
+    if (len == 0) return STD_ERR_OK;
+    if (len == 1) return sub_intf_attr_fn(intf_name,val[0]);
+
+    NAS_VLAN_INTERFACE *vlan_obj = dynamic_cast<NAS_VLAN_INTERFACE *> (nas_interface_map_obj_get(intf_name));
+    if (vlan_obj == nullptr) {
+        EV_LOGGING(INTERFACE,ERR,"SUB-INTF-ATTR-SET","No Interface %s exists in the map",intf_name.c_str());
+        return STD_ERR(INTERFACE,PARAM,0);
+    }
+    if (!vlan_obj->nas_is_1d_br_member()) {
+        return STD_ERR_OK;
     }
 
-    return rc;
+    nas_sub_intf_parent_ndi_t parent;
+    t_std_error rc = STD_ERR_OK;
+    if((rc = nas_interface_utils_sub_intf_parent_get(vlan_obj->parent_name_get(), parent))!=STD_ERR_OK){
+        return rc;
+    }
+    return nas_interface_utils_sub_intf_attrs_set(vlan_obj, parent, val, len);
 }
 
 t_std_error nas_interface_utils_set_all_sub_intf_attr(const std::string & parent_intf,  nas_com_id_value_t  val[],
@@ -807,14 +918,37 @@ t_std_error nas_interface_utils_set_all_sub_intf_attr(const std::string & parent
         EV_LOGGING(INTERFACE,ERR,"SUB-INTF-ATTR-SET","No Interface %s exsist in the map",parent_intf.c_str());
         return STD_ERR(INTERFACE,PARAM,0);
     }
+    if (len == 0 || obj->sub_intf_count() == 0) return STD_ERR_OK;
+
+    /*  All the sub interfaces share this parent, so resolve its NDI object once and
+     *  then send all the attributes of each 1D sub port in one NDI call */
+    nas_sub_intf_parent_ndi_t parent;
+    bool parent_valid = false;
+    t_std_error parent_rc = STD_ERR_OK;
+
+    obj->for_each_sub_intf([&](const std::string & intf_name) {
+        NAS_VLAN_INTERFACE *vlan_obj = dynamic_cast<NAS_VLAN_INTERFACE *> (nas_interface_map_obj_get(intf_name));
+        if (vlan_obj == nullptr) {
+            EV_LOGGING(INTERFACE,ERR,"SUB-INTF-ATTR-SET","No Interface %s exists in the map",intf_name.c_str());
+            return;
+        }
+        /*  Attribute setting is only applicable for 1D bridge sub ports */
+        if (!vlan_obj->nas_is_1d_br_member()) return;
 
-    t_std_error rc = STD_ERR_OK;
-    for(size_t ix = 0 ; ix < len ; ++ix){
-        rc = obj->for_all_sub_intf(sub_intf_attr_fn,val[ix]);
-        if(rc != STD_ERR_OK) break;
-    }
+        if (!parent_valid && parent_rc == STD_ERR_OK) {
+            parent_rc = nas_interface_utils_sub_intf_parent_get(parent_intf, parent);
+            parent_valid = (parent_rc == STD_ERR_OK);
+        }
+        if (!parent_valid) return;
 
-    return rc;
+        /*  A sub port failure is logged and does not stop the others */
+        if (nas_interface_utils_sub_intf_attrs_set(vlan_obj, parent, val, len) != STD_ERR_OK) {
+            EV_LOGGING(INTERFACE,ERR,"SUB-INTF-ATTR-SET","Failed to set attributes on sub interface %s",
+                       intf_name.c_str());
+        }
+    });
+
+    return parent_rc;
 }
 
 t_std_error nas_interface_util_mgmt_create (std::string intf_name, hal_ifindex_t intf_idx)
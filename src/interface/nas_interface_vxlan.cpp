@@ -95,7 +95,12 @@ t_std_error NAS_VXLAN_INTERFACE::nas_vxlan_os_enable_flooding(remote_endpoint_t
 
 t_std_error NAS_VXLAN_INTERFACE::nas_interface_add_remote_endpoint(remote_endpoint_t *remote_endpoint)
 {
-    remote_endpoint_list.push_back(*remote_endpoint);
+    auto idx = remote_endpoint_index.find(remote_endpoint->remote_ip);
+    if (idx != remote_endpoint_index.end()) {
+        return nas_interface_update_remote_endpoint(remote_endpoint);
+    }
+    auto it = remote_endpoint_list.insert(remote_endpoint_list.end(), *remote_endpoint);
+    remote_endpoint_index[remote_endpoint->remote_ip] = it;
     if (remote_endpoint->flooding_enabled) {
         nas_vxlan_os_enable_flooding(*remote_endpoint, true);
     }
@@ -115,17 +120,18 @@ t_std_error NAS_VXLAN_INTERFACE::nas_interface_update_all_rem_endpt_flooding() {
 /*  Remvoe remote endpoint from the vxlan object */
 t_std_error NAS_VXLAN_INTERFACE::nas_interface_remove_remote_endpoint(remote_endpoint_t *remote_endpoint)
 {
-    for (auto it = remote_endpoint_list.begin(); it != remote_endpoint_list.end(); it++) {
-        if (it->remote_ip == remote_endpoint->remote_ip) {
-            *remote_endpoint = *it;
-            if (!remote_endpoint->flooding_enabled) {
-                nas_vxlan_os_enable_flooding(*remote_endpoint, false);
-            }
-            remote_endpoint_list.erase(it);
-            return STD_ERR_OK;
-        }
+    auto idx = remote_endpoint_index.find(remote_endpoint->remote_ip);
+    if (idx == remote_endpoint_index.end()) {
+        return STD_ERR(INTERFACE, FAIL, 0);
     }
-    return STD_ERR(INTERFACE, FAIL, 0);
+    auto it = idx->second;
+    *remote_endpoint = *it;
+    if (!remote_endpoint->flooding_enabled) {
+        nas_vxlan_os_enable_flooding(*remote_endpoint, false);
+    }
+    remote_endpoint_index.erase(idx);
+    remote_endpoint_list.erase(it);
+    return STD_ERR_OK;
 }
 
 /* Base on IP address  get remote endpoint info */
@@ -135,13 +141,12 @@ t_std_error NAS_VXLAN_INTERFACE::nas_interface_get_remote_endpoint(remote_endpoi
     if (remote_endpoint == NULL) {
         return STD_ERR(INTERFACE,FAIL,0);
     }
-    for (auto it = remote_endpoint_list.begin(); it != remote_endpoint_list.end(); it++) {
-        if (it->remote_ip == remote_endpoint->remote_ip) {
-            *remote_endpoint = *it;
-            return STD_ERR_OK;
-        }
+    auto idx = remote_endpoint_index.find(remote_endpoint->remote_ip);
+    if (idx == remote_endpoint_index.end()) {
+        return STD_ERR(INTERFACE, FAIL, 0);
     }
-    return STD_ERR(INTERFACE, FAIL, 0);
+    *remote_endpoint = *(idx->second);
+    return STD_ERR_OK;
 
 }
 
@@ -152,16 +157,16 @@ t_std_error NAS_VXLAN_INTERFACE::nas_interface_update_remote_endpoint(remote_end
         return STD_ERR(INTERFACE,FAIL,0);
     }
 
-    for (auto it = remote_endpoint_list.begin(); it != remote_endpoint_list.end(); it++) {
-        if (it->remote_ip == remote_endpoint->remote_ip) {
-            if (remote_endpoint->flooding_enabled != it->flooding_enabled) {
-                nas_vxlan_os_enable_flooding(*remote_endpoint, remote_endpoint->flooding_enabled);
-            }
-            *it = *remote_endpoint;
-            return STD_ERR_OK;
-        }
+    auto idx = remote_endpoint_index.find(remote_endpoint->remote_ip);
+    if (idx == remote_endpoint_index.end()) {
+        return STD_ERR(INTERFACE, FAIL, 0);
+    }
+    auto it = idx->second;
+    if (remote_endpoint->flooding_enabled != it->flooding_enabled) {
+        nas_vxlan_os_enable_flooding(*remote_endpoint, remote_endpoint->flooding_enabled);
     }
-    return STD_ERR(INTERFACE, FAIL, 0);
+    *it = *remote_endpoint;
+    return STD_ERR_OK;
 }
 
 
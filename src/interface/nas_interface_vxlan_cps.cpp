@@ -281,12 +281,17 @@ static t_std_error  _nas_vxlan_handle_remote_endpoints(const std::string & vxlan
         _rem_ep_list.push_back(cur_ep);
     }
     t_std_error rc = STD_ERR_OK;
-    for(auto it : _rem_ep_list){
-        if( member_op == DELL_BASE_IF_CMN_UPDATE_TYPE_ADD){
-           if((rc = nas_bridge_utils_add_remote_endpoint(vxlan_name.c_str(),it)) != STD_ERR_OK) return  rc;
-        }else if (member_op == DELL_BASE_IF_CMN_UPDATE_TYPE_REMOVE) {
-            if((rc = nas_bridge_utils_remove_remote_endpoint(vxlan_name.c_str(),it)) != STD_ERR_OK) return rc;
-        } else if (member_op == DELL_BASE_IF_CMN_UPDATE_TYPE_UPDATE){
+    if (_rem_ep_list.empty()) {
+        return STD_ERR_OK;
+    }
+    /*  Add and remove resolve the vxlan and bridge once for the whole list */
+    if( member_op == DELL_BASE_IF_CMN_UPDATE_TYPE_ADD){
+        return nas_bridge_utils_add_remote_endpoints(vxlan_name.c_str(), _rem_ep_list);
+    }else if (member_op == DELL_BASE_IF_CMN_UPDATE_TYPE_REMOVE) {
+        return nas_bridge_utils_remove_remote_endpoints(vxlan_name.c_str(), _rem_ep_list);
+    }
+    for(auto &it : _rem_ep_list){
+        if (member_op == DELL_BASE_IF_CMN_UPDATE_TYPE_UPDATE){
             if((rc = nas_bridge_utils_update_remote_endpoint(vxlan_name.c_str(),it)) != STD_ERR_OK) return rc;
         }
     }
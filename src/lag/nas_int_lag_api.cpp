@@ -35,6 +35,8 @@
 #include "nas_ndi_lag.h"
 #include "nas_switch.h"
 
+#include <mutex>
+
 
 /** struct nas_lag_slave_info_t
  *   NAS Lag slave info structure
@@ -43,6 +45,7 @@ typedef struct {
     hal_ifindex_t ifindex;
     hal_ifindex_t master_idx;
     ndi_obj_id_t ndi_lag_member_id;
+    ndi_port_t ndi_port;
 }nas_lag_slave_info_t;
 
 typedef hal_ifindex_t  slave_ifindex;
@@ -64,6 +67,24 @@ static auto nas_lag_slave_table = new nas_lag_slave_table_t;
  */
 auto nas_lag_master_table = new nas_lag_master_table_t;
 
+/*
+ * NDI lag id to master ifindex, kept with the master table
+ */
+static auto nas_lag_ndi_id_table = new std::unordered_map<ndi_obj_id_t, hal_ifindex_t>;
+
+
+/*
+ * NPU port to LAG member, read on the NDI thread by the fast failover path
+ * without the LAG lock. Entries are removed before the member is deleted in
+ * the NPU, and an entry is not removed while its member is being written.
+ */
+static std::mutex nas_lag_port_mtx;
+static auto nas_lag_port_table = new std::unordered_map<uint64_t, nas_lag_slave_info_t>;
+
+static inline uint64_t nas_lag_port_key(npu_id_t npu, npu_port_t port)
+{
+    return ((uint64_t) (uint32_t) npu << 32) | (uint32_t) port;
+}
 
 static std_mutex_lock_create_static_init_rec(lag_lock);
 
@@ -73,18 +94,55 @@ std_mutex_type_t *nas_lag_mutex_lock()
 }
 
 t_std_error nas_add_slave_node(hal_ifindex_t lag_master_id,hal_ifindex_t ifindex,
-        ndi_obj_id_t ndi_lag_member_id){
+        ndi_obj_id_t ndi_lag_member_id, ndi_port_t *ndi_port){
 
     EV_LOGGING(INTERFACE, INFO, "NAS-LAG","LagID %d Ifindex %d, lag mem id %lu",
                lag_master_id, ifindex, ndi_lag_member_id);
 
-    nas_lag_slave_table->insert({ifindex ,{ ifindex, lag_master_id ,ndi_lag_member_id}});
+    nas_lag_slave_info_t slave_entry = { ifindex, lag_master_id ,ndi_lag_member_id, *ndi_port};
+    nas_lag_slave_table->insert({ifindex, slave_entry});
+
+    std::lock_guard<std::mutex> l(nas_lag_port_mtx);
+    (*nas_lag_port_table)[nas_lag_port_key(ndi_port->npu_id, ndi_port->npu_port)] = slave_entry;
     return STD_ERR_OK;
 }
 
 
+/* Stop the fast failover path from using the member */
+static void nas_lag_port_table_erase(hal_ifindex_t ifindex)
+{
+    auto slave_table_it = nas_lag_slave_table->find(ifindex);
+    if (slave_table_it == nas_lag_slave_table->end()) {
+        return;
+    }
+    ndi_port_t &port = slave_table_it->second.ndi_port;
+
+    std::lock_guard<std::mutex> l(nas_lag_port_mtx);
+    auto port_it = nas_lag_port_table->find(nas_lag_port_key(port.npu_id, port.npu_port));
+    if (port_it != nas_lag_port_table->end() && port_it->second.ifindex == ifindex) {
+        nas_lag_port_table->erase(port_it);
+    }
+}
+
+
+/* Let the fast failover path use the member again */
+static void nas_lag_port_table_restore(hal_ifindex_t ifindex)
+{
+    auto slave_table_it = nas_lag_slave_table->find(ifindex);
+    if (slave_table_it == nas_lag_slave_table->end()) {
+        return;
+    }
+    nas_lag_slave_info_t &slave_entry = slave_table_it->second;
+
+    std::lock_guard<std::mutex> l(nas_lag_port_mtx);
+    (*nas_lag_port_table)[nas_lag_port_key(slave_entry.ndi_port.npu_id,
+                                           slave_entry.ndi_port.npu_port)] = slave_entry;
+}
+
+
 t_std_error nas_remove_slave_node(hal_ifindex_t ifindex)
 {
+    nas_lag_port_table_erase(ifindex);
     auto slave_table_it = nas_lag_slave_table->find(ifindex);
     if (slave_table_it != nas_lag_slave_table->end()) {
         nas_lag_slave_table->erase(slave_table_it);
@@ -93,6 +151,30 @@ t_std_error nas_remove_slave_node(hal_ifindex_t ifindex)
 }
 
 
+bool nas_lag_port_member_get(npu_id_t npu, npu_port_t port, hal_ifindex_t *ifindex)
+{
+    std::lock_guard<std::mutex> l(nas_lag_port_mtx);
+    auto port_it = nas_lag_port_table->find(nas_lag_port_key(npu, port));
+    if (port_it == nas_lag_port_table->end()) {
+        return false;
+    }
+    *ifindex = port_it->second.ifindex;
+    return true;
+}
+
+
+bool nas_lag_port_member_egress_disable(npu_id_t npu, npu_port_t port, bool *found)
+{
+    std::lock_guard<std::mutex> l(nas_lag_port_mtx);
+    auto port_it = nas_lag_port_table->find(nas_lag_port_key(npu, port));
+    *found = (port_it != nas_lag_port_table->end());
+    if (!*found) {
+        return false;
+    }
+    return nas_set_lag_member_attr(npu, port_it->second.ndi_lag_member_id, true) == STD_ERR_OK;
+}
+
+
 nas_lag_slave_info_t *nas_get_slave_node(hal_ifindex_t ifindex)
 {
     auto slave_table_it = nas_lag_slave_table->find(ifindex);
@@ -128,7 +210,9 @@ t_std_error nas_remove_all_slave_node(nas_lag_master_info_t *nas_lag_entry)
 
 void nas_lag_entry_insert(nas_lag_master_info_t &master_entry)
 {
-    nas_lag_master_table->insert({master_entry.ifindex, master_entry});
+    if (nas_lag_master_table->insert({master_entry.ifindex, master_entry}).second) {
+        (*nas_lag_ndi_id_table)[master_entry.ndi_lag_id] = master_entry.ifindex;
+    }
 }
 
 
@@ -137,6 +221,7 @@ t_std_error nas_lag_entry_erase(hal_ifindex_t ifindex)
     auto master_table_it = nas_lag_master_table->find(ifindex);
 
     if (master_table_it != nas_lag_master_table->end()) {
+        nas_lag_ndi_id_table->erase(master_table_it->second.ndi_lag_id);
         nas_lag_master_table->erase(master_table_it);
     }else {
         EV_LOGGING(INTERFACE, ERR, "NAS-LAG","Invalid Lag Index %d", ifindex);
@@ -160,12 +245,31 @@ nas_lag_master_info_t *nas_get_lag_node(hal_ifindex_t ifindex)
 }
 
 
+nas_lag_master_info_t *nas_get_lag_node_by_ndi_id(ndi_obj_id_t ndi_lag_id)
+{
+    auto ndi_id_it = nas_lag_ndi_id_table->find(ndi_lag_id);
+    if (ndi_id_it == nas_lag_ndi_id_table->end()) {
+        EV_LOGGING(INTERFACE, INFO, "NAS-LAG", "No Lag Found for ndi id %lu", ndi_lag_id);
+        return NULL;
+    }
+    return nas_get_lag_node(ndi_id_it->second);
+}
+
+
 nas_lag_master_table_t & nas_get_lag_table(void)
 {
     return *nas_lag_master_table;
 }
 
 
+void nas_lag_for_each(std::function<bool (nas_lag_master_info_t &)> fn)
+{
+    for (auto &it : *nas_lag_master_table) {
+        if (!fn(it.second)) break;
+    }
+}
+
+
 static bool nas_lag_exist(const char *bond_name)
 {
     interface_ctrl_t intf_ctrl;
@@ -239,7 +343,7 @@ t_std_error nas_lag_member_add(hal_ifindex_t lag_master_id,hal_ifindex_t ifindex
     }
 
     // Adding master NDI id to slave list.
-    if(nas_add_slave_node(lag_master_id,ifindex,ndi_lag_member_id) != STD_ERR_OK){
+    if(nas_add_slave_node(lag_master_id,ifindex,ndi_lag_member_id,&nas_lag_ndi_port) != STD_ERR_OK){
         return  STD_ERR(INTERFACE,FAIL, 0);
     }
 
@@ -292,8 +396,13 @@ t_std_error nas_lag_member_delete(hal_ifindex_t lag_master_id,hal_ifindex_t ifin
 
     EV_LOGGING(INTERFACE, INFO, "NAS-Lag", "Deleting LAG MEM ID %lu",
                nas_slave_entry->ndi_lag_member_id);
+    nas_lag_port_table_erase(ifindex);
     if(nas_del_port_from_lag(nas_lag_ndi_port.npu_id,
                 nas_slave_entry->ndi_lag_member_id) != STD_ERR_OK){
+        // Still a member, keep it on the fast failover path
+        std::lock_guard<std::mutex> l(nas_lag_port_mtx);
+        (*nas_lag_port_table)[nas_lag_port_key(nas_slave_entry->ndi_port.npu_id,
+                                               nas_slave_entry->ndi_port.npu_port)] = *nas_slave_entry;
         return STD_ERR(INTERFACE,FAIL, 0);
     }
 
@@ -390,8 +499,15 @@ t_std_error nas_lag_master_delete(hal_ifindex_t ifindex)
                    ifindex);
         return STD_ERR(INTERFACE,FAIL, 0);
     }
+    for (auto slave_ifindex : nas_lag_entry->port_list) {
+        nas_lag_port_table_erase(slave_ifindex);
+    }
     /* @TODO - NPU ID for Multi-npu case */
     if(nas_lag_delete(0, nas_lag_entry->ndi_lag_id) != STD_ERR_OK){
+        /* LAG is still in the NPU, keep failing over its members */
+        for (auto slave_ifindex : nas_lag_entry->port_list) {
+            nas_lag_port_table_restore(slave_ifindex);
+        }
         return STD_ERR(INTERFACE,FAIL, 0);
     }
 
@@ -517,22 +633,13 @@ t_std_error nas_lag_block_port(nas_lag_master_info_t  *nas_lag_entry ,hal_ifinde
         return STD_ERR_OK;
     }
 
-    ndi_port_t nas_lag_ndi_port;
-    interface_ctrl_t intf_ctrl;
-    if (!nas_lag_intf_to_port(slave_ifindex, &intf_ctrl)) {
-        return (STD_ERR(INTERFACE,FAIL, 0));
-    }
-
-    nas_lag_ndi_port.npu_id = intf_ctrl.npu_id;
-    nas_lag_ndi_port.npu_port= intf_ctrl.port_id;
-
-    // Retrive ndi_lag_member_id
+    // Retrive ndi_lag_member_id and the port saved when the member was added
     nas_slave_entry = nas_get_slave_node (slave_ifindex);
     if(nas_slave_entry == NULL){
         return STD_ERR(INTERFACE,FAIL, 0);
     }
 
-    if(nas_set_lag_member_attr(nas_lag_ndi_port.npu_id,nas_slave_entry->ndi_lag_member_id,
+    if(nas_set_lag_member_attr(nas_slave_entry->ndi_port.npu_id,nas_slave_entry->ndi_lag_member_id,
                 block_state) != STD_ERR_OK) {
         return (STD_ERR(INTERFACE,FAIL,0));
     }
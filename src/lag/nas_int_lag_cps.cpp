@@ -47,6 +47,7 @@
 #include "interface/nas_interface_map.h"
 #include "interface/nas_interface_utils.h"
 #include "std_rw_lock.h"
+#include "hal_shell.h"
 
 #include <stdio.h>
 
@@ -54,6 +55,8 @@
 #include "cps_api_events.h"
 #include "cps_api_object_key.h"
 #include <unordered_set>
+#include <atomic>
+#include <chrono>
 
 
 const static int MAX_CPS_MSG_BUFF=4096;
@@ -1205,85 +1208,56 @@ static t_std_error nas_get_lag_intf(hal_ifindex_t ifindex, cps_api_object_list_t
 
 static t_std_error nas_lag_get_all_info(cps_api_object_list_t list, bool get_intf_state)
 {
-    nas_lag_master_info_t *nas_lag_entry = NULL;
-    nas_lag_master_table_t nas_lag_master_table;
+    t_std_error rc = STD_ERR_OK;
 
     EV_LOGGING(INTERFACE, INFO, "NAS-LAG-CPS", "Getting all lag %s", (get_intf_state ? "interface-states" : "interfaces"));
 
-    nas_lag_master_table = nas_get_lag_table();
-
-    for (auto it =nas_lag_master_table.begin();it != nas_lag_master_table.end();++it){
-
-        EV_LOGGING(INTERFACE, INFO, "NAS-LAG-CPS", "Inside Loop");
+    nas_lag_for_each([&](nas_lag_master_info_t &nas_lag_entry) {
         cps_api_object_t obj = cps_api_object_list_create_obj_and_append(list);
         if (obj == NULL) {
             EV_LOGGING(INTERFACE, ERR, "NAS-CPS-LAG", "obj NULL failure");
-            return STD_ERR(INTERFACE, NOMEM, 0);
-        }
-
-        nas_lag_entry = nas_get_lag_node(it->first);
-
-        if(nas_lag_entry == NULL) {
-            EV_LOGGING(INTERFACE, ERR, "NAS-LAG-CPS",
-                       "Error finding lagnode %d for get operation", it->first);
-            return(STD_ERR(INTERFACE, FAIL, 0));
+            rc = STD_ERR(INTERFACE, NOMEM, 0);
+            return false;
         }
 
         if(get_intf_state) {
-            nas_pack_lag_if_state(obj, nas_lag_entry);
+            nas_pack_lag_if_state(obj, &nas_lag_entry);
         } else {
-            nas_pack_lag_if(obj, nas_lag_entry);
+            nas_pack_lag_if(obj, &nas_lag_entry);
         }
-    }
+        return true;
+    });
 
-    return STD_ERR_OK;
+    return rc;
 }
 
 t_std_error nas_lag_ndi_it_to_obj_fill(nas_obj_id_t ndi_lag_id,cps_api_object_list_t list, bool get_intf_state)
 {
     nas_lag_master_info_t *nas_lag_entry = NULL;
-    nas_lag_master_table_t nas_lag_master_table;
 
     EV_LOGGING(INTERFACE, INFO, "NAS-LAG-CPS", "Fill opaque data....");
 
     if(ndi_lag_id == 0)
         return STD_ERR(INTERFACE, FAIL, 0);
 
-    nas_lag_master_table = nas_get_lag_table();
-    for (auto it =nas_lag_master_table.begin();it != nas_lag_master_table.end();++it){
-
-
-        nas_lag_entry = nas_get_lag_node(it->first);
-
-        if(nas_lag_entry == NULL) {
-            EV_LOGGING(INTERFACE, ERR, "NAS-LAG-CPS",
-                       "Error finding lag Entry %d for get operation",
-                       it->first);
-            return(STD_ERR(INTERFACE, FAIL, 0));
-        }
-
-        EV_LOGGING(INTERFACE, INFO, "NAS-LAG-CPS",
-                   "Lg id %lu and appid %lu",
-                   nas_lag_entry->ndi_lag_id, ndi_lag_id);
-
-        if(nas_lag_entry->ndi_lag_id == ndi_lag_id){
-            cps_api_object_t obj = cps_api_object_list_create_obj_and_append(list);
-            if(obj == NULL) {
-                EV_LOGGING(INTERFACE, ERR, "NAS-CPS-LAG", "obj NULL failure");
-                return STD_ERR(INTERFACE, NOMEM, 0);
-            }
+    nas_lag_entry = nas_get_lag_node_by_ndi_id(ndi_lag_id);
+    if(nas_lag_entry == NULL) {
+        return (STD_ERR(INTERFACE,FAIL,0));
+    }
 
-            if(get_intf_state) {
-                nas_pack_lag_if_state(obj,nas_lag_entry);
-            } else {
-                nas_pack_lag_if(obj,nas_lag_entry);
-            }
+    cps_api_object_t obj = cps_api_object_list_create_obj_and_append(list);
+    if(obj == NULL) {
+        EV_LOGGING(INTERFACE, ERR, "NAS-CPS-LAG", "obj NULL failure");
+        return STD_ERR(INTERFACE, NOMEM, 0);
+    }
 
-            return STD_ERR_OK;
-        }
+    if(get_intf_state) {
+        nas_pack_lag_if_state(obj,nas_lag_entry);
+    } else {
+        nas_pack_lag_if(obj,nas_lag_entry);
     }
 
-    return (STD_ERR(INTERFACE,FAIL,0));
+    return STD_ERR_OK;
 }
 
 static cps_api_return_code_t nas_process_cps_lag_get(void * context, cps_api_get_params_t * param,
@@ -1444,27 +1418,14 @@ static cps_api_return_code_t nas_process_cps_lag_resilient_get(void * context,
  */
 static void nas_process_lag_paths_rh_update(bool new_setting)
 {
-    nas_lag_master_info_t *nas_lag_entry = NULL;
-    nas_lag_master_table_t nas_lag_master_table;
     npu_id_t npu = 0;   //@TODO to retrive NPU ID in multi npu case
 
     EV_LOGGING(INTERFACE, INFO, "NAS-CPS-LAG", "nas_process_lag_paths_rh_update");
 
-    nas_lag_master_table = nas_get_lag_table();
-
-    for (auto it = nas_lag_master_table.begin();it != nas_lag_master_table.end(); ++it){
-
-        EV_LOGGING(INTERFACE, INFO, "NAS-LAG-CPS", "Inside Loop");
-        nas_lag_entry = nas_get_lag_node(it->first);
-
-        if(nas_lag_entry == NULL) {
-            EV_LOGGING(INTERFACE, ERR, "NAS-LAG-CPS",
-                       "Error finding lagnode %d for RH update operation", it->first);
-            return;
-        }
-
-        ndi_set_lag_resilient_hash(npu, nas_lag_entry->ndi_lag_id, new_setting);
-    }
+    nas_lag_for_each([&](nas_lag_master_info_t &nas_lag_entry) {
+        ndi_set_lag_resilient_hash(npu, nas_lag_entry.ndi_lag_id, new_setting);
+        return true;
+    });
     return;
 }
 
@@ -1549,19 +1510,77 @@ t_std_error nas_process_cps_lag_globals_init(cps_api_operation_handle_t nas_proc
 }
 
 
+/*
+ * Member down to egress disable latency of the fast failover path. Bucket ix
+ * counts the latencies below 2^ix us, the last one everything above.
+ */
+#define NAS_LAG_FAILOVER_HIST_BUCKETS 24
+static std::atomic<uint64_t> nas_lag_failover_hist[NAS_LAG_FAILOVER_HIST_BUCKETS];
+static std::atomic<uint64_t> nas_lag_failover_failed(0);
+
+static void nas_lag_failover_hist_add(uint64_t usec)
+{
+    size_t ix = 0;
+    while (ix < NAS_LAG_FAILOVER_HIST_BUCKETS - 1 && usec >= (1ULL << ix)) {
+        ++ix;
+    }
+    ++nas_lag_failover_hist[ix];
+}
+
+static void nas_lag_failover_dump(std_parsed_string_t handle)
+{
+    printf("LAG member failover latency (member down to egress disable)\n");
+    for (size_t ix = 0; ix < NAS_LAG_FAILOVER_HIST_BUCKETS; ++ix) {
+        uint64_t cnt = nas_lag_failover_hist[ix].load();
+        if (cnt == 0) continue;
+        uint64_t lo = (ix == 0) ? 0 : (1ULL << (ix - 1));
+        if (ix == NAS_LAG_FAILOVER_HIST_BUCKETS - 1) {
+            printf("  >= %9llu us %12llu\n", (unsigned long long) lo, (unsigned long long) cnt);
+        } else {
+            printf("  %6llu-%-6llu us %12llu\n", (unsigned long long) lo,
+                   (unsigned long long) (1ULL << ix), (unsigned long long) cnt);
+        }
+    }
+    printf("  %-16s %12llu\n", "failed", (unsigned long long) nas_lag_failover_failed.load());
+}
+
+/*
+ * Runs on the NDI thread ahead of the other oper state handlers, so a member
+ * that goes down stops taking traffic without waiting for the link event
+ * workers. The LAG state and events are updated later by
+ * nas_lag_port_oper_state_cb().
+ */
+static void nas_lag_port_fast_failover_cb(npu_id_t npu, npu_port_t port,
+                                          IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_t status)
+{
+    if (status != IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_DOWN) {
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    bool found = false;
+    if (!nas_lag_port_member_egress_disable(npu, port, &found)) {
+        if (found) {
+            ++nas_lag_failover_failed;
+            EV_LOGGING(INTERFACE, ERR, "NAS-CPS-LAG",
+                       "Failed to disable LAG member on port <%d %d>", npu, port);
+        }
+        return;
+    }
+    nas_lag_failover_hist_add(std::chrono::duration_cast<std::chrono::microseconds>(
+                              std::chrono::steady_clock::now() - start).count());
+}
+
 void nas_lag_port_oper_state_cb(npu_id_t npu, npu_port_t port, IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_t status)
 {
-    ndi_port_t ndi_port;
-    ndi_port.npu_id = npu;
-    ndi_port.npu_port = port;
     hal_ifindex_t slave_index, master_index;
     bool block_status = true;
 
     EV_LOGGING(INTERFACE, INFO, "NAS-CPS-LAG",
                       "LAG member port oper status processing");
 
-    if (nas_int_get_if_index_from_npu_port(&slave_index, &ndi_port) != STD_ERR_OK) {
-        return;
+    if (!nas_lag_port_member_get(npu, port, &slave_index)) {
+        return; // not a part of any lag  so nothing to do
     }
     std_mutex_simple_lock_guard lock_t(nas_lag_mutex_lock());
     if ( (master_index = nas_get_master_idx(slave_index)) == -1 ) {
@@ -1703,6 +1722,8 @@ t_std_error nas_cps_lag_init(cps_api_operation_handle_t lag_intf_handle) {
 
     /*  register a handler for physical port oper state change */
     nas_int_oper_state_register_cb(nas_lag_port_oper_state_cb);
+    nas_int_oper_state_register_fast_cb(nas_lag_port_fast_failover_cb);
+    hal_shell_cmd_add("lag-failover", nas_lag_failover_dump, "Displays the LAG member failover latency histogram");
 
     if (cps_api_event_service_init() != cps_api_ret_code_OK) {
         return STD_ERR(INTERFACE,FAIL,0);
@@ -405,6 +405,39 @@ _base_to_ietf64bit_speed = {
     {BASE_IF_SPEED_100GIGE,     100*SPEED_1GIGE},
 };
 
+/*
+ * Removing objects one by one moves the rest of the list each time, which is
+ * quadratic when most of a long OS interface dump is filtered out.
+ */
+void nas_intf_obj_list_filter(cps_api_object_list_t list, std::function<bool (cps_api_object_t)> keep) {
+    cps_api_object_list_guard kept(cps_api_object_list_create());
+    if (!kept.valid()) {
+        // Fall back to removing in place
+        size_t ix = 0;
+        size_t mx = cps_api_object_list_size(list);
+        while (ix < mx) {
+            cps_api_object_t obj = cps_api_object_list_get(list, ix);
+            if (keep(obj)) {
+                ++ix;
+                continue;
+            }
+            cps_api_object_list_remove(list, ix);
+            cps_api_object_delete(obj);
+            --mx;
+        }
+        return;
+    }
+
+    for (size_t ix = 0, mx = cps_api_object_list_size(list); ix < mx; ++ix) {
+        cps_api_object_t obj = cps_api_object_list_get(list, ix);
+        if (!keep(obj) || !cps_api_object_list_append(kept.get(), obj)) {
+            cps_api_object_delete(obj);
+        }
+    }
+    cps_api_object_list_clear(list, false);
+    cps_api_object_list_merge(list, kept.get());
+}
+
 bool nas_base_to_ietf_state_speed(BASE_IF_SPEED_t speed, uint64_t *ietf_speed) {
     auto it = _base_to_ietf64bit_speed.find(speed);
     if (it != _base_to_ietf64bit_speed.end()) {
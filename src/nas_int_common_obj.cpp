@@ -36,10 +36,13 @@
 
 #include "hal_if_mapping.h"
 #include "interface/nas_interface_utils.h"
+#include "nas_os_interface.h"
+#include "nas_int_com_utils.h"
 
 typedef struct _intf_obj_handler_s {
     cps_rdfn obj_rd;
     cps_wrfn obj_wr;
+    cps_fillfn obj_fill;
 } intf_obj_handler_t;
 
 #define NUM_INT_CPS_API_THREAD 1
@@ -117,6 +120,37 @@ static void cps_api_object_list_swap(cps_api_object_list_t &a, cps_api_object_li
     b = t;
 }
 
+/*
+ * Interfaces of all the types with a fill handler from a single OS interface dump;
+ * each interface is passed to the fill handler of its type.
+ */
+static cps_api_return_code_t _if_fill_all_interfaces(obj_intf_cat_t obj_cat, void* context,
+                                                     cps_api_object_t filt, cps_api_object_list_t list) {
+    if (nas_os_get_interface(filt, list) != STD_ERR_OK) {
+        EV_LOGGING(INTERFACE, ERR, "NAS-COM-INT-GET", "Failed to get interfaces from OS");
+        return cps_api_ret_code_ERR;
+    }
+
+    nas_intf_obj_list_filter(list, [&](cps_api_object_t object) {
+        cps_api_object_attr_t ifix = cps_api_object_attr_get(object,
+                                            DELL_BASE_IF_CMN_IF_INTERFACES_INTERFACE_IF_INDEX);
+        if (ifix == nullptr) return false;
+
+        interface_ctrl_t intf;
+        memset(&intf, 0, sizeof(intf));
+        intf.if_index = cps_api_object_attr_data_u32(ifix);
+        intf.q_type = HAL_INTF_INFO_FROM_IF;
+        if (dn_hal_get_interface_info(&intf) != STD_ERR_OK) return false;
+
+        auto it = _intf_handlers[obj_cat].find(intf.int_type);
+        if (it == _intf_handlers[obj_cat].end() || it->second == NULL || it->second->obj_fill == NULL) {
+            return false;
+        }
+        return it->second->obj_fill(context, object, &intf);
+    });
+    return cps_api_ret_code_OK;
+}
+
 static cps_api_return_code_t _if_get_all_interfaces(obj_intf_cat_t obj_cat, void* context,
                                              cps_api_get_params_t* param, size_t key_ix) {
     cps_api_attr_id_t _type_attr_id = (obj_cat == obj_INTF) ?
@@ -126,9 +160,26 @@ static cps_api_return_code_t _if_get_all_interfaces(obj_intf_cat_t obj_cat, void
     cps_api_object_t filt = cps_api_object_list_get(param->filters,key_ix);
 
     cps_api_object_list_t list = cps_api_object_list_create();
+
+    bool have_fill = false;
+    for (auto& iter: _intf_handlers[obj_cat]) {
+        if (iter.second != NULL && iter.second->obj_fill != NULL) {
+            have_fill = true;
+            break;
+        }
+    }
+    if (have_fill) {
+        if (_if_fill_all_interfaces(obj_cat, context, filt, list) != cps_api_ret_code_OK) {
+            cps_api_object_list_destroy(list, true);
+            return cps_api_ret_code_ERR;
+        }
+        cps_api_object_list_merge(param->list, list);
+        cps_api_object_list_clear(list, true);
+    }
+
     char if_type[256];
     for (auto& iter: _intf_handlers[obj_cat]) {
-        if (iter.second != NULL && iter.second->obj_rd != NULL) {
+        if (iter.second != NULL && iter.second->obj_rd != NULL && iter.second->obj_fill == NULL) {
             if (!nas_to_ietf_if_type_get(iter.first, if_type, sizeof(if_type))) {
                 EV_LOGGING(INTERFACE, ERR, "NAS-COM-INT-GET", "Failed to get IETF type for NAS type %d",
                            iter.first);
@@ -288,11 +339,23 @@ t_std_error intf_obj_handler_registration(obj_intf_cat_t obj_cat, nas_int_type_t
     if (h == NULL) return STD_ERR(INTERFACE,FAIL,0); // TODO error type
     h->obj_rd = rd;
     h->obj_wr = wr;
+    h->obj_fill = NULL;
 
     _intf_handlers[obj_cat][intf_type] =  h;
     return STD_ERR_OK;
 }
 
+t_std_error intf_obj_fill_registration(obj_intf_cat_t obj_cat, nas_int_type_t intf_type, cps_fillfn fill) {
+    auto it = _intf_handlers[obj_cat].find(intf_type);
+    if (it == _intf_handlers[obj_cat].end() || it->second == NULL) {
+        EV_LOGGING(INTERFACE,ERR,"NAS-IF-REG","No handler registered for obj category %d and type %d",
+                   obj_cat, intf_type);
+        return STD_ERR(INTERFACE,PARAM,0);
+    }
+    it->second->obj_fill = fill;
+    return STD_ERR_OK;
+}
+
 static t_std_error _reg_module(cps_api_operation_handle_t handle, cps_api_attr_id_t id,
                                cps_api_qualifier_t qual, cps_rdfn rd, cps_wrfn wr) {
     cps_api_registration_functions_t f;
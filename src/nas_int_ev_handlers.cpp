@@ -28,6 +28,7 @@
 #include "nas_int_lag.h"
 #include "nas_int_lag_api.h"
 #include "nas_int_com_utils.h"
+#include "nas_vrf.h"
 #include "bridge/nas_interface_bridge_utils.h"
 #include "bridge/nas_interface_bridge_com.h"
 #include "interface/nas_interface_lag.h"
@@ -1013,8 +1014,19 @@ bool nas_int_ev_handler_cb(cps_api_object_t obj, void *param) {
     }
     EV_LOGGING(INTERFACE,INFO,"INTF-EV","OS event received for interface state change.");
     BASE_CMN_INTERFACE_TYPE_t if_type = (BASE_CMN_INTERFACE_TYPE_t) cps_api_object_attr_data_u32(_type);
+
     cps_api_object_attr_t _vrf_attr = cps_api_object_attr_get(obj, VRF_MGMT_NI_IF_INTERFACES_INTERFACE_VRF_ID);
 
+    /* A deleted router interface must not be served from the VRF router interface cache */
+    if (cps_api_object_type_operation(cps_api_object_key(obj)) == cps_api_oper_DELETE) {
+        cps_api_object_attr_t _if_attr = cps_api_object_attr_get(obj,
+                DELL_BASE_IF_CMN_IF_INTERFACES_INTERFACE_IF_INDEX);
+        if ((_if_attr != nullptr) && (_vrf_attr != nullptr)) {
+            nas_vrf_rt_intf_cache_del(cps_api_object_attr_data_u32(_vrf_attr),
+                                      cps_api_object_attr_data_u32(_if_attr));
+        }
+    }
+
     /*  only in case of mgmt interface events are processed un-conditionally.
      *  Otherwise in case of CPS only configuration for interface.
      *  interface events are ignored.
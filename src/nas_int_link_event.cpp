@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * nas_int_link_event.cpp
+ */
+
+#include "nas_int_link_event.h"
+
+#include "cps_api_events.h"
+#include "dell-base-if.h"
+#include "event_log.h"
+#include "hal_shell.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <pthread.h>
+#include <stdio.h>
+
+typedef struct _nas_link_evt_port_t {
+    IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_t status;
+    bool dirty;                 // status not handled yet
+    bool queued;                // in the ready queue
+    bool busy;                  // being handled by a worker
+} nas_link_evt_port_t;
+
+typedef struct _nas_link_evt_cnt_t {
+    uint64_t posted;
+    uint64_t coalesced;         // replaced by a later state before being handled
+    uint64_t handled;
+    uint64_t published;
+    uint64_t publish_dropped;   // replaced by a later event of the same batch
+    uint64_t max_depth;
+} nas_link_evt_cnt_t;
+
+static std::mutex _evt_mtx;
+static std::condition_variable _evt_cv;
+static std::unordered_map<uint64_t, nas_link_evt_port_t> _evt_ports;
+static std::deque<uint64_t> _evt_ready;
+static std::vector<cps_api_object_t> _evt_batch;
+static nas_link_evt_cnt_t _evt_cnt;
+static oper_state_handler_t _evt_dispatch = nullptr;
+static bool _evt_running = false;
+
+/* Held while a batch is sent so batches go out in the order they were taken */
+static std::mutex _evt_pub_mtx;
+
+static thread_local bool _evt_worker = false;
+
+static inline uint64_t _evt_key(npu_id_t npu, npu_port_t port)
+{
+    return ((uint64_t) (uint32_t) npu << 32) | (uint32_t) port;
+}
+
+static bool _evt_same_intf(cps_api_object_t a, cps_api_object_t b)
+{
+    if (cps_api_key_matches(cps_api_object_key(a), cps_api_object_key(b), true) != 0) {
+        return false;
+    }
+    cps_api_object_attr_t a_ix = cps_api_object_attr_get(a, IF_INTERFACES_STATE_INTERFACE_IF_INDEX);
+    cps_api_object_attr_t b_ix = cps_api_object_attr_get(b, IF_INTERFACES_STATE_INTERFACE_IF_INDEX);
+    return a_ix != nullptr && b_ix != nullptr &&
+           cps_api_object_attr_data_u32(a_ix) == cps_api_object_attr_data_u32(b_ix);
+}
+
+bool nas_int_link_event_batch_add(cps_api_object_t obj)
+{
+    if (!_evt_worker) return false;
+
+    cps_api_object_t cp = cps_api_object_create();
+    if (cp == nullptr || !cps_api_object_clone(cp, obj)) {
+        if (cp != nullptr) cps_api_object_delete(cp);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> l(_evt_mtx);
+    //Only the latest state of an interface is worth sending
+    for (auto& ev : _evt_batch) {
+        if (_evt_same_intf(ev, cp)) {
+            cps_api_object_delete(ev);
+            ev = cp;
+            ++_evt_cnt.publish_dropped;
+            return true;
+        }
+    }
+    _evt_batch.push_back(cp);
+    return true;
+}
+
+static void _evt_batch_flush()
+{
+    std::lock_guard<std::mutex> p_l(_evt_pub_mtx);
+
+    std::vector<cps_api_object_t> batch;
+    {
+        std::lock_guard<std::mutex> l(_evt_mtx);
+        batch.swap(_evt_batch);
+    }
+    if (batch.empty()) return;
+
+    for (auto ev : batch) {
+        if (cps_api_event_thread_publish(ev) != cps_api_ret_code_OK) {
+            EV_LOGGING(INTERFACE, ERR, "NAS-LINK-EVT", "Failed to send event.  Service issue");
+        }
+        cps_api_object_delete(ev);
+    }
+    std::lock_guard<std::mutex> l(_evt_mtx);
+    _evt_cnt.published += batch.size();
+}
+
+static void *_evt_worker_main(void *arg)
+{
+    _evt_worker = true;
+
+    std::unique_lock<std::mutex> l(_evt_mtx);
+    while (true) {
+        if (_evt_ready.empty()) {
+            //Nothing left to coalesce with, send what was collected
+            if (!_evt_batch.empty()) {
+                l.unlock();
+                _evt_batch_flush();
+                l.lock();
+                continue;
+            }
+            _evt_cv.wait(l);
+            continue;
+        }
+
+        uint64_t key = _evt_ready.front();
+        _evt_ready.pop_front();
+        nas_link_evt_port_t& p = _evt_ports[key];
+        p.queued = false;
+        p.dirty = false;
+        p.busy = true;
+        IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_t status = p.status;
+        l.unlock();
+
+        _evt_dispatch((npu_id_t) (key >> 32), (npu_port_t) (key & 0xffffffff), status);
+
+        l.lock();
+        ++_evt_cnt.handled;
+        //Changed while handled, the latest state goes to the back of the queue
+        nas_link_evt_port_t& q = _evt_ports[key];
+        q.busy = false;
+        if (q.dirty) {
+            q.queued = true;
+            _evt_ready.push_back(key);
+        }
+        if (_evt_batch.size() >= NAS_INT_LINK_EVT_BATCH) {
+            l.unlock();
+            _evt_batch_flush();
+            l.lock();
+        }
+    }
+    return nullptr;
+}
+
+void nas_int_link_event_post(npu_id_t npu, npu_port_t port,
+                             IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_t status)
+{
+    {
+        std::lock_guard<std::mutex> l(_evt_mtx);
+        if (_evt_running) {
+            ++_evt_cnt.posted;
+            nas_link_evt_port_t& p = _evt_ports[_evt_key(npu, port)];
+            if (p.dirty) ++_evt_cnt.coalesced;
+            p.status = status;
+            p.dirty = true;
+            if (!p.queued && !p.busy) {
+                p.queued = true;
+                _evt_ready.push_back(_evt_key(npu, port));
+                if (_evt_ready.size() > _evt_cnt.max_depth) _evt_cnt.max_depth = _evt_ready.size();
+                _evt_cv.notify_one();
+            }
+            return;
+        }
+    }
+    if (_evt_dispatch != nullptr) _evt_dispatch(npu, port, status);
+}
+
+static void _evt_dump(std_parsed_string_t handle)
+{
+    nas_link_evt_cnt_t cnt;
+    size_t depth;
+    bool running;
+    {
+        std::lock_guard<std::mutex> l(_evt_mtx);
+        cnt = _evt_cnt;
+        depth = _evt_ready.size();
+        running = _evt_running;
+    }
+    printf("Link state events (%s)\n", running ? "queued to workers" : "handled inline");
+    printf("  %-18s %llu\n", "posted", (unsigned long long) cnt.posted);
+    printf("  %-18s %llu\n", "coalesced", (unsigned long long) cnt.coalesced);
+    printf("  %-18s %llu\n", "handled", (unsigned long long) cnt.handled);
+    printf("  %-18s %llu\n", "published", (unsigned long long) cnt.published);
+    printf("  %-18s %llu\n", "publish-replaced", (unsigned long long) cnt.publish_dropped);
+    printf("  %-18s %lu\n", "queued", depth);
+    printf("  %-18s %llu\n", "max-queued", (unsigned long long) cnt.max_depth);
+}
+
+t_std_error nas_int_link_event_init(oper_state_handler_t dispatch)
+{
+    _evt_dispatch = dispatch;
+
+    size_t started = 0;
+    for (size_t ix = 0; ix < NAS_INT_LINK_EVT_WORKERS; ++ix) {
+        pthread_t thr;
+        int err = pthread_create(&thr, NULL, _evt_worker_main, NULL);
+        if (err != 0) {
+            EV_LOGGING(INTERFACE, ERR, "NAS-LINK-EVT", "Failed to create link event worker %d", err);
+            break;
+        }
+        pthread_setname_np(thr, "nas_link_evt");
+        pthread_detach(thr);
+        ++started;
+    }
+
+    hal_shell_cmd_add("link-events", _evt_dump, "Displays the link state event queue counters");
+
+    if (started == 0) {
+        //Events are handled on the NDI thread
+        return STD_ERR(INTERFACE, FAIL, 0);
+    }
+    std::lock_guard<std::mutex> l(_evt_mtx);
+    _evt_running = true;
+    return STD_ERR_OK;
+}
@@ -58,11 +58,13 @@
 
 #include "nas_os_interface.h"
 #include "nas_ndi_port.h"
+#include "nas_int_link_event.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>
 #include <set>
+#include <atomic>
 
 #define NUM_INT_CPS_API_THREAD 1
 
@@ -70,6 +72,8 @@ static cps_api_operation_handle_t nas_if_handle;
 extern t_std_error mgmt_intf_init (void);
 
 void hal_interface_send_event(cps_api_object_t obj) {
+    if (nas_int_link_event_batch_add(obj)) return;
+
     if (cps_api_event_thread_publish(obj)!=STD_ERR_OK) {
         EV_LOGGING(INTERFACE,ERR,"NAS-INTF-EVENT","Failed to send event.  Service issue");
     }
@@ -83,15 +87,39 @@ void nas_int_oper_state_register_cb(oper_state_handler_t oper_state_cb) {
     }
 }
 
-static void hw_link_state_cb(npu_id_t npu, npu_port_t port,
-        ndi_intf_link_state_t *data) {
+/* Filled at init while the NDI thread may already be reading them */
+static oper_state_handler_t oper_state_fast_handlers[NAS_INT_OPER_STATE_FAST_CB_MAX];
+static std::atomic<size_t> oper_state_fast_handler_cnt(0);
 
-    IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_t status = ndi_to_cps_oper_type(data->oper_status);
+void nas_int_oper_state_register_fast_cb(oper_state_handler_t oper_state_cb) {
+    size_t ix = oper_state_fast_handler_cnt.load();
+    if (oper_state_cb == NULL) return;
+    if (ix >= NAS_INT_OPER_STATE_FAST_CB_MAX) {
+        EV_LOGGING(INTERFACE,ERR,"NAS-INT-INIT","No room for another fast oper state handler");
+        return;
+    }
+    oper_state_fast_handlers[ix] = oper_state_cb;
+    oper_state_fast_handler_cnt.store(ix + 1);
+}
+
+/* Runs on a link event worker with the latest state of the port */
+static void link_state_dispatch(npu_id_t npu, npu_port_t port,
+        IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_t status) {
     for (auto it = oper_state_handlers->begin(); it != oper_state_handlers->end(); ++it) {
         (*it)(npu, port, status);
     }
 }
 
+static void hw_link_state_cb(npu_id_t npu, npu_port_t port,
+        ndi_intf_link_state_t *data) {
+    IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_t status = ndi_to_cps_oper_type(data->oper_status);
+    size_t cnt = oper_state_fast_handler_cnt.load();
+    for (size_t ix = 0; ix < cnt; ++ix) {
+        oper_state_fast_handlers[ix](npu, port, status);
+    }
+    nas_int_link_event_post(npu, port, status);
+}
+
 t_std_error nas_if_get_assigned_mac(const char *if_type,
                                     const char *if_name,
                                     hal_vlan_id_t vlan_id,
@@ -208,6 +236,9 @@ t_std_error hal_interface_init(void) {
         return STD_ERR(CPSNAS,FAIL,0);
     }
 
+    if (nas_int_link_event_init(link_state_dispatch) != STD_ERR_OK) {
+        EV_LOGGING(INTERFACE, ERR,"NAS-INT-INIT","Link state events are handled on the NDI thread");
+    }
     if (ndi_port_oper_state_notify_register(hw_link_state_cb)!=STD_ERR_OK) {
         EV_LOGGING(INTERFACE, ERR,"NAS-INT-INIT","Initializing Interface callback failed");
         return STD_ERR(INTERFACE,FAIL,0);
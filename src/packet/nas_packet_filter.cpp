@@ -71,6 +71,7 @@ nas_obj_id_t pf_table::pf_t_add_rule(pf_direction dir, pf_rule& rule) {
                                    rule.pf_r_get_id(), egress_rules);
         pf_egress_table.emplace_back(rule);
     }
+    pf_t_compile(dir);
 
     return rule.pf_r_get_id();
 }
@@ -114,9 +115,11 @@ bool pf_table::pf_t_del_rule(nas_obj_id_t id) {
 
     if((del = pf_gen_erase_id(pf_ingress_table, id))) {
         --ingress_rules;
+        pf_t_compile(BASE_PACKET_PACKET_DIRECTION_TYPE_DIR_IN);
         EV_LOGGING (NAS_PKT_FILTER, DEBUG,"PKT-FIL","Ingress rule %lu deleted, rem %d", id, ingress_rules);
     } else if((del = pf_gen_erase_id(pf_egress_table, id))) {
         --egress_rules;
+        pf_t_compile(BASE_PACKET_PACKET_DIRECTION_TYPE_DIR_OUT);
         EV_LOGGING (NAS_PKT_FILTER, DEBUG,"PKT-FIL","Egress rule %lu deleted, rem %d", id, egress_rules);
     }
 
@@ -126,6 +129,15 @@ bool pf_table::pf_t_del_rule(nas_obj_id_t id) {
     return del;
 }
 
+void pf_table::pf_t_compile(pf_direction dir) {
+
+    if (dir == BASE_PACKET_PACKET_DIRECTION_TYPE_DIR_IN) {
+        std::atomic_store(&pf_ingress_cls, std::make_shared<pf_classifier>(pf_ingress_table));
+    } else {
+        std::atomic_store(&pf_egress_cls, std::make_shared<pf_classifier>(pf_egress_table));
+    }
+}
+
 /*
  * Return true if you want to terminate handling this packet and stop processing further actions
  */
@@ -134,53 +146,135 @@ bool pf_table::pf_t_in_pkt_hndlr(uint8_t *pkt, uint32_t pkt_len, pf_pkt_attr *p_
     EV_LOGGING (NAS_PKT_FILTER, DEBUG,"PKT-FIL","In_Pkt handler - len %d, port %d, trap id %lld",
 		pkt_len, p_attr->rx_port, p_attr->trap_id);
 
-    std::lock_guard<std::mutex> pf_tlock {pf_mtx};
+    auto cls = std::atomic_load(&pf_ingress_cls);
+    if (!cls) return false;
+
+    return cls->pf_c_classify(pkt, pkt_len, p_attr);
+}
 
-    for (auto pfr : pf_ingress_table) {
-        EV_LOGGING (NAS_PKT_FILTER, DEBUG,"PKT-FIL","Scanning rule id %lu", pfr.pf_r_get_id());
-        bool match = true, action = true;
+bool pf_table::pf_t_out_pkt_hndlr(uint8_t *pkt, uint32_t pkt_len, pf_pkt_attr *p_attr) {
 
-        //Consider using std::invoke
-        pfr.pf_r_get_match_params([&](pf_match_t& m_tv) {
-            const pf_match ref = pfr.pf_r_get_match_list();
-            match &= ref.pf_m_inv_fptr(m_tv.m_type, pkt, pkt_len, p_attr, m_tv);
-        });
+    EV_LOGGING (NAS_PKT_FILTER, DEBUG,"PKT-FIL","Out_Pkt handler - len %d, port %d",
+                                pkt_len, p_attr->tx_port);
 
-        if(match) {
-            pfr.pf_r_get_action_params([&](pf_action_t& a_tv) {
-                const pf_action ref = pfr.pf_r_get_action_list();
-                action &= ref.trigger_action(pkt, pkt_len, p_attr, a_tv);
-            });
-            if(pfr.pf_r_get_stop()) return true;
-        }
+    auto cls = std::atomic_load(&pf_egress_cls);
+    if (!cls) return false;
+
+    return cls->pf_c_classify(pkt, pkt_len, p_attr);
+}
+
+/*
+ * Run the egress rules on a burst of packets, the same rule set is used for the whole burst
+ */
+void pf_table::pf_t_out_pkt_burst_hndlr(uint8_t **pkt, uint32_t *pkt_len, pf_pkt_attr *p_attr,
+                                        size_t count) {
+
+    auto cls = std::atomic_load(&pf_egress_cls);
+    if (!cls) return;
+
+    for (size_t ix = 0; ix < count; ++ix) {
+        cls->pf_c_classify(pkt[ix], pkt_len[ix], &p_attr[ix]);
     }
+}
 
-    return false;
+/*
+ * Classifier Definitions
+ */
+
+static inline uint64_t pf_mac_key(const uint8_t *mac) {
+    uint64_t key = 0;
+    memcpy(&key, mac, HAL_MAC_ADDR_LEN);
+    return key;
 }
 
-bool pf_table::pf_t_out_pkt_hndlr(uint8_t *pkt, uint32_t pkt_len, pf_pkt_attr *p_attr) {
+pf_classifier::pf_classifier(const std::vector<pf_rule>& rules) {
 
-    EV_LOGGING (NAS_PKT_FILTER, DEBUG,"PKT-FIL","Out_Pkt handler - len %d, port %d",
-                                pkt_len, p_attr->tx_port);
+    entries.reserve(rules.size());
 
-    std::lock_guard<std::mutex> pf_tlock {pf_mtx};
+    for (const auto& pfr : rules) {
+        pf_c_entry ent;
+        bool has_trap = false, has_mac = false, supported = true;
+        uint64_t trap_id = 0;
 
-    for (auto pfr : pf_egress_table) {
-        EV_LOGGING (NAS_PKT_FILTER, DEBUG,"PKT-FIL","Scanning rule id %lu", pfr.pf_r_get_id());
-        bool match = true, action = true;
+        ent.id = pfr.pf_r_get_id();
+        ent.stop = pfr.pf_r_get_stop();
 
-        //Consider using std::invoke
         pfr.pf_r_get_match_params([&](pf_match_t& m_tv) {
-            const pf_match ref = pfr.pf_r_get_match_list();
-            match &= ref.pf_m_inv_fptr(m_tv.m_type, pkt, pkt_len, p_attr, m_tv);
+            switch (m_tv.m_type) {
+            case BASE_PACKET_PACKET_MATCH_TYPE_HOSTIF_USER_TRAP_ID:
+                has_trap = true;
+                trap_id = m_tv.m_val.u64;
+                break;
+            case BASE_PACKET_PACKET_MATCH_TYPE_DST_MAC:
+                has_mac = true;
+                memcpy(ent.mac, m_tv.m_val.mac, HAL_MAC_ADDR_LEN);
+                break;
+            default:
+                //Match evaluation not supported, the rule never matches
+                supported = false;
+                break;
+            }
+        });
+
+        if (!supported) {
+            EV_LOGGING (NAS_PKT_FILTER, DEBUG,"PKT-FIL","Rule %lu has unsupported match, skipped",
+                        ent.id);
+            continue;
+        }
+
+        pfr.pf_r_get_action_params([&](pf_action_t& a_tv) {
+            ent.actions.push_back(a_tv);
         });
-        if(match) {
-            pfr.pf_r_get_action_params([&](pf_action_t& a_tv) {
-                const pf_action ref = pfr.pf_r_get_action_list();
-                action &= ref.trigger_action(pkt, pkt_len, p_attr, a_tv);
-            });
-            if(pfr.pf_r_get_stop()) return true;
+
+        size_t idx = entries.size();
+        if (has_trap) {
+            ent.chk_mac = has_mac;
+            by_trap_id[trap_id].push_back(idx);
+        } else if (has_mac) {
+            by_mac[pf_mac_key(ent.mac)].push_back(idx);
+        } else {
+            wildcard.push_back(idx);
         }
+        entries.push_back(std::move(ent));
+    }
+}
+
+bool pf_classifier::pf_c_classify(uint8_t *pkt, uint32_t pkt_len, pf_pkt_attr *p_attr) {
+
+    static const std::vector<size_t> no_rules;
+
+    auto t_it = by_trap_id.find(p_attr->trap_id);
+    const std::vector<size_t>& t_lst = (t_it != by_trap_id.end()) ? t_it->second : no_rules;
+
+    const std::vector<size_t> *m_lst = &no_rules;
+    if (pkt_len >= HAL_MAC_ADDR_LEN) {
+        auto m_it = by_mac.find(pf_mac_key(pkt));
+        if (m_it != by_mac.end()) m_lst = &m_it->second;
+    }
+
+    //Merge the candidate lists to run the matching rules in table order
+    size_t t_ix = 0, m_ix = 0, w_ix = 0;
+    while (true) {
+        size_t idx = entries.size();
+        if (t_ix < t_lst.size()) idx = t_lst[t_ix];
+        if (m_ix < m_lst->size() && (*m_lst)[m_ix] < idx) idx = (*m_lst)[m_ix];
+        if (w_ix < wildcard.size() && wildcard[w_ix] < idx) idx = wildcard[w_ix];
+        if (idx == entries.size()) break;
+
+        if (t_ix < t_lst.size() && t_lst[t_ix] == idx) ++t_ix;
+        else if (m_ix < m_lst->size() && (*m_lst)[m_ix] == idx) ++m_ix;
+        else ++w_ix;
+
+        pf_c_entry& ent = entries[idx];
+        if (ent.chk_mac && (pkt_len < HAL_MAC_ADDR_LEN || memcmp(pkt, ent.mac, HAL_MAC_ADDR_LEN))) {
+            continue;
+        }
+        EV_LOGGING (NAS_PKT_FILTER, DEBUG,"PKT-FIL","Matched rule id %lu", ent.id);
+
+        for (auto& a_tv : ent.actions) {
+            ent.action_lst.trigger_action(pkt, pkt_len, p_attr, a_tv);
+        }
+        if (ent.stop) return true;
     }
 
     return false;
@@ -377,6 +471,11 @@ bool nas_pf_out_pkt_hndlr(uint8_t *pkt, uint32_t pkt_len, ndi_packet_attr_t *p_a
     return pf_table_inst->pf_t_out_pkt_hndlr(pkt, pkt_len, p_attr);
 }
 
+void nas_pf_out_pkt_burst_hndlr(uint8_t **pkt, uint32_t *pkt_len, ndi_packet_attr_t *p_attr,
+                                size_t count) {
+    pf_table_inst->pf_t_out_pkt_burst_hndlr(pkt, pkt_len, p_attr, count);
+}
+
 /*
  * CPS OBJ Handlers - API Definitions
  */
@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * nas_sflow_export.c
+ *
+ * The NDI RX callback copies the sampled packet header into a single
+ * producer/single consumer ring. The exporter thread drains the ring and
+ * sends the samples to the sFlow agent in batches with sendmmsg; it is only
+ * woken up (through an eventfd) when it went idle on an empty ring.
+ */
+#define _GNU_SOURCE
+
+#include "nas_sflow_export.h"
+#include "nas_int_pkt_io_cfg.h"
+#include "nas_packet_meta.h"
+#include "std_socket_tools.h"
+
+#include "event_log.h"
+#include "event_log_types.h"
+
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+/* Default sFlow agent address, can be changed through CPS */
+#define SFLOW_PKT_DEF_IP    "127.0.0.1"
+#define SFLOW_PKT_DEF_PORT   20001
+
+/* Room for the meta data TLVs of one sample */
+#define SFLOW_META_BUF_SIZE  256
+
+#define SFLOW_CACHE_LINE     64
+
+typedef struct _nas_sflow_sample_t {
+    hal_ifindex_t rx_ifindex;
+    hal_ifindex_t tx_ifindex;
+    uint64_t sample_count;
+    uint32_t pkt_len;           // length of the sampled packet
+    uint32_t hdr_len;           // bytes of it held in hdr
+    uint8_t *hdr;               // slot in the header pool
+} nas_sflow_sample_t;
+
+static struct {
+    /* written by the producer only */
+    size_t head __attribute__((aligned(SFLOW_CACHE_LINE)));
+    uint64_t sample_count;
+
+    /* written by the exporter only */
+    size_t tail __attribute__((aligned(SFLOW_CACHE_LINE)));
+    int idle;                   // exporter waits on evt_fd, cleared by whoever wakes it
+
+    nas_sflow_sample_t *ring __attribute__((aligned(SFLOW_CACHE_LINE)));
+    uint8_t *hdr_pool;
+    size_t size;                // power of 2
+    size_t hdr_max;
+    size_t batch;
+    int evt_fd;
+    int sock_fd;
+    pthread_t thr;
+} _sflow_exp = { .evt_fd = -1, .sock_fd = -1 };
+
+static nas_sflow_export_stats_t _sflow_stats;
+
+/* Destination is set through CPS, the exporter copies it once per batch */
+static pthread_mutex_t _sflow_dest_lock = PTHREAD_MUTEX_INITIALIZER;
+static std_socket_address_t _sflow_dest;
+
+static inline void _sflow_stat_add(uint64_t *cnt, uint64_t val)
+{
+    __atomic_add_fetch(cnt, val, __ATOMIC_RELAXED);
+}
+
+void nas_sflow_export_dest_get(dn_ipv4_addr_t *ip, int *port)
+{
+    pthread_mutex_lock(&_sflow_dest_lock);
+    *ip = _sflow_dest.address.inet4addr.sin_addr;
+    *port = ntohs(_sflow_dest.address.inet4addr.sin_port);
+    pthread_mutex_unlock(&_sflow_dest_lock);
+}
+
+void nas_sflow_export_dest_set(const dn_ipv4_addr_t *ip, int port)
+{
+    pthread_mutex_lock(&_sflow_dest_lock);
+    _sflow_dest.address.inet4addr.sin_family = AF_INET;
+    _sflow_dest.address.inet4addr.sin_addr = *ip;
+    _sflow_dest.addr_type = e_std_socket_a_t_INET; // Common for all INET families
+    _sflow_dest.type = e_std_sock_INET4;
+    _sflow_dest.address.inet4addr.sin_port = htons(port);
+    pthread_mutex_unlock(&_sflow_dest_lock);
+}
+
+void nas_sflow_export_stats_get(nas_sflow_export_stats_t *stats)
+{
+    stats->enqueued = __atomic_load_n(&_sflow_stats.enqueued, __ATOMIC_RELAXED);
+    stats->exported = __atomic_load_n(&_sflow_stats.exported, __ATOMIC_RELAXED);
+    stats->truncated = __atomic_load_n(&_sflow_stats.truncated, __ATOMIC_RELAXED);
+    stats->batches = __atomic_load_n(&_sflow_stats.batches, __ATOMIC_RELAXED);
+    stats->drop_overflow = __atomic_load_n(&_sflow_stats.drop_overflow, __ATOMIC_RELAXED);
+    stats->drop_no_port = __atomic_load_n(&_sflow_stats.drop_no_port, __ATOMIC_RELAXED);
+    stats->drop_send_err = __atomic_load_n(&_sflow_stats.drop_send_err, __ATOMIC_RELAXED);
+    stats->drop_unsent = __atomic_load_n(&_sflow_stats.drop_unsent, __ATOMIC_RELAXED);
+}
+
+void nas_sflow_export_drop_no_port(void)
+{
+    _sflow_stat_add(&_sflow_stats.drop_no_port, 1);
+}
+
+t_std_error nas_sflow_export_enqueue(const uint8_t *pkt, uint32_t pkt_len,
+                                     hal_ifindex_t rx_ifindex, hal_ifindex_t tx_ifindex)
+{
+    if (_sflow_exp.ring == NULL) return STD_ERR(INTERFACE, FAIL, 0);
+
+    size_t head = _sflow_exp.head;
+    if (head - __atomic_load_n(&_sflow_exp.tail, __ATOMIC_ACQUIRE) == _sflow_exp.size) {
+        _sflow_stat_add(&_sflow_stats.drop_overflow, 1);
+        return STD_ERR(INTERFACE, FAIL, ENOBUFS);
+    }
+
+    nas_sflow_sample_t *s = &_sflow_exp.ring[head & (_sflow_exp.size - 1)];
+    s->rx_ifindex = rx_ifindex;
+    s->tx_ifindex = tx_ifindex;
+    /* wraps around to 0 after the max value of uint64_t */
+    s->sample_count = _sflow_exp.sample_count++;
+    s->pkt_len = pkt_len;
+    s->hdr_len = pkt_len;
+    if (s->hdr_len > _sflow_exp.hdr_max) {
+        s->hdr_len = _sflow_exp.hdr_max;
+        _sflow_stat_add(&_sflow_stats.truncated, 1);
+    }
+    memcpy(s->hdr, pkt, s->hdr_len);
+
+    /* publish the sample before checking if the exporter went idle */
+    __atomic_store_n(&_sflow_exp.head, head + 1, __ATOMIC_SEQ_CST);
+    _sflow_stat_add(&_sflow_stats.enqueued, 1);
+
+    if (__atomic_load_n(&_sflow_exp.idle, __ATOMIC_SEQ_CST) &&
+        __atomic_exchange_n(&_sflow_exp.idle, 0, __ATOMIC_SEQ_CST)) {
+        uint64_t one = 1;
+        if (write(_sflow_exp.evt_fd, &one, sizeof(one)) < 0) {
+            EV_LOGGING(NAS_PKT_IO, ERR, "SFlow", "Failed to wake up exporter - %s", strerror(errno));
+        }
+    }
+    return STD_ERR_OK;
+}
+
+/* Block until the producer queues a sample */
+static void _sflow_export_wait(void)
+{
+    __atomic_store_n(&_sflow_exp.idle, 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&_sflow_exp.head, __ATOMIC_SEQ_CST) != _sflow_exp.tail) {
+        __atomic_store_n(&_sflow_exp.idle, 0, __ATOMIC_SEQ_CST);
+        return;
+    }
+
+    uint64_t val;
+    while (read(_sflow_exp.evt_fd, &val, sizeof(val)) < 0 && errno == EINTR) ;
+    __atomic_store_n(&_sflow_exp.idle, 0, __ATOMIC_SEQ_CST);
+}
+
+static void *_sflow_export_main(void *arg)
+{
+    size_t batch = _sflow_exp.batch;
+    struct mmsghdr *msgs = calloc(batch, sizeof(*msgs));
+    struct iovec *iov = calloc(batch * 2, sizeof(*iov));
+    uint8_t *meta = malloc(batch * SFLOW_META_BUF_SIZE);
+
+    if (msgs == NULL || iov == NULL || meta == NULL) {
+        EV_LOGGING(NAS_PKT_IO, ERR, "SFlow", "Failed to allocate exporter batch of %lu", batch);
+        free(msgs);
+        free(iov);
+        free(meta);
+        return NULL;
+    }
+
+    for ( ; ; ) {
+        size_t tail = _sflow_exp.tail;
+        size_t avail = __atomic_load_n(&_sflow_exp.head, __ATOMIC_ACQUIRE) - tail;
+        if (avail == 0) {
+            _sflow_export_wait();
+            continue;
+        }
+        size_t n = (avail < batch) ? avail : batch;
+
+        struct sockaddr_in dest;
+        pthread_mutex_lock(&_sflow_dest_lock);
+        dest = _sflow_dest.address.inet4addr;
+        pthread_mutex_unlock(&_sflow_dest_lock);
+
+        size_t ix;
+        for (ix = 0; ix < n; ++ix) {
+            const nas_sflow_sample_t *s = &_sflow_exp.ring[(tail + ix) & (_sflow_exp.size - 1)];
+            uint8_t *meta_buf = meta + ix * SFLOW_META_BUF_SIZE;
+
+            nas_pkt_meta_attr_it_t it;
+            nas_pkt_meta_buf_init (meta_buf, SFLOW_META_BUF_SIZE, &it);
+            nas_pkt_meta_add_u32 (&it, NAS_PKT_META_RX_PORT, s->rx_ifindex);
+            nas_pkt_meta_add_u32 (&it, NAS_PKT_META_TX_PORT, s->tx_ifindex);
+            nas_pkt_meta_add_u64 (&it, NAS_PKT_META_SAMPLE_COUNT, s->sample_count);
+            /* original frame length, the header may have been truncated */
+            nas_pkt_meta_add_u32 (&it, NAS_PKT_META_PKT_LEN, s->pkt_len);
+
+            iov[2 * ix].iov_base = meta_buf;
+            iov[2 * ix].iov_len = SFLOW_META_BUF_SIZE - it.len;
+            iov[2 * ix + 1].iov_base = s->hdr;
+            iov[2 * ix + 1].iov_len = s->hdr_len;
+
+            memset(&msgs[ix].msg_hdr, 0, sizeof(msgs[ix].msg_hdr));
+            msgs[ix].msg_hdr.msg_name = &dest;
+            msgs[ix].msg_hdr.msg_namelen = sizeof(dest);
+            msgs[ix].msg_hdr.msg_iov = &iov[2 * ix];
+            msgs[ix].msg_hdr.msg_iovlen = 2;
+        }
+
+        size_t sent = 0;
+        while (sent < n) {
+            int rc = sendmmsg(_sflow_exp.sock_fd, &msgs[sent], n - sent, 0);
+            _sflow_stat_add(&_sflow_stats.batches, 1);
+            if (rc > 0) {
+                _sflow_stat_add(&_sflow_stats.exported, rc);
+                sent += rc;
+                continue;
+            }
+            if (rc == 0) {
+                /* nothing was sent and there is no error to report, give up
+                 * on the rest of the batch rather than spin on it
+                 */
+                _sflow_stat_add(&_sflow_stats.drop_unsent, n - sent);
+                break;
+            }
+            if (errno == EINTR) continue;
+
+            /* skip the sample that failed */
+            EV_LOGGING(NAS_PKT_IO, DEBUG, "SFlow", "Send to UDP socket %d failed - %s",
+                       _sflow_exp.sock_fd, strerror(errno));
+            _sflow_stat_add(&_sflow_stats.drop_send_err, 1);
+            ++sent;
+        }
+
+        /* slots can be reused by the producer once sent */
+        __atomic_store_n(&_sflow_exp.tail, tail + n, __ATOMIC_RELEASE);
+    }
+
+    return NULL;
+}
+
+/* undo a partial nas_sflow_export_init */
+static void _sflow_export_cleanup(void)
+{
+    free(_sflow_exp.ring);
+    free(_sflow_exp.hdr_pool);
+    _sflow_exp.ring = NULL;
+    _sflow_exp.hdr_pool = NULL;
+    if (_sflow_exp.evt_fd >= 0) close(_sflow_exp.evt_fd);
+    _sflow_exp.evt_fd = -1;
+    if (_sflow_exp.sock_fd >= 0) close(_sflow_exp.sock_fd);
+    _sflow_exp.sock_fd = -1;
+}
+
+t_std_error nas_sflow_export_init(void)
+{
+    const nas_pkt_io_cfg_t *cfg = nas_pkt_io_cfg_get();
+
+    t_std_error rc = std_socket_create (e_std_sock_INET4, e_std_sock_type_DGRAM,
+                                        0, NULL, &_sflow_exp.sock_fd);
+    if (rc != STD_ERR_OK) {
+        EV_LOGGING (NAS_PKT_IO, ERR, "SFlow", "socket Error %d", rc);
+        return rc;
+    }
+
+    rc = std_sock_addr_from_ip_str (e_std_sock_INET4, SFLOW_PKT_DEF_IP,
+                                    SFLOW_PKT_DEF_PORT, &_sflow_dest);
+    if (rc != STD_ERR_OK) {
+        EV_LOGGING (NAS_PKT_IO, ERR, "SFlow", "socket address creation error %d", rc);
+    }
+
+    size_t size = 1;
+    while (size < cfg->sflow_ring) size <<= 1;
+
+    _sflow_exp.evt_fd = eventfd(0, EFD_CLOEXEC);
+    _sflow_exp.ring = calloc(size, sizeof(nas_sflow_sample_t));
+    size_t hdr_max = (cfg->sflow_header_len != 0) ? cfg->sflow_header_len
+                                                   : NAS_PKT_IO_MAX_SFLOW_HEADER_LEN;
+    _sflow_exp.hdr_pool = malloc(size * hdr_max);
+    if (_sflow_exp.evt_fd < 0 || _sflow_exp.ring == NULL || _sflow_exp.hdr_pool == NULL) {
+        int err = errno;
+        EV_LOGGING (NAS_PKT_IO, ERR, "SFlow", "Failed to create sample queue of %lu", size);
+        _sflow_export_cleanup();
+        return STD_ERR(INTERFACE, FAIL, err);
+    }
+
+    size_t ix;
+    for (ix = 0; ix < size; ++ix) {
+        _sflow_exp.ring[ix].hdr = _sflow_exp.hdr_pool + ix * hdr_max;
+    }
+    _sflow_exp.size = size;
+    _sflow_exp.hdr_max = hdr_max;
+    _sflow_exp.batch = cfg->sflow_batch;
+
+    int err = pthread_create(&_sflow_exp.thr, NULL, _sflow_export_main, NULL);
+    if (err) {
+        EV_LOGGING (NAS_PKT_IO, ERR, "SFlow", "Failed to start exporter - %s", strerror(err));
+        _sflow_export_cleanup();
+        return STD_ERR(INTERFACE, FAIL, err);
+    }
+    pthread_setname_np(_sflow_exp.thr, "hal_sflow_exp");
+
+    return STD_ERR_OK;
+}
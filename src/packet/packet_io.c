@@ -40,6 +40,8 @@
 #include "dell-base-sflow.h"
 #include "dell-base-packet.h"
 #include "nas_packet_filter.h"
+#include "nas_sflow_export.h"
+#include "nas_int_pkt_io_stats.h"
 
 #include <sys/socket.h>
 #include <linux/if.h>
@@ -64,21 +66,81 @@
  * Global variables
  */
 static int pkt_debug = 0;
-static uint64_t sample_count=0;
 
-static uint64_t packets_txed; // cumulative packet txed
-static uint64_t packets_txed_to_pipeline_bypass; // packet txed directly to egress bypassing the pipeline
-static uint64_t packets_txed_to_pipeline_lookup; // packet txed to ingress pipeline
-static uint64_t packets_txed_to_pipeline_lookup_hybrid; // packet txed to ingress pipeline hybrid
-static uint64_t packets_rxed;
 static uint8_t  pkt_buf[MAX_PKT_LEN];
 
 void pkt_debug_counters(std_parsed_string_t handle) {
-    printf("RX                      : %llu\n", (unsigned long long)packets_rxed);
-    printf("TX (total)              : %llu\n", (unsigned long long)packets_txed);
-    printf("TX (pipeline bypass)    : %llu\n", (unsigned long long)packets_txed_to_pipeline_bypass);
-    printf("TX (pipeline lookup)    : %llu\n", (unsigned long long)packets_txed_to_pipeline_lookup);
+    nas_pkt_io_stats_t *stats = malloc(sizeof(*stats));
+    if (stats == NULL) return;
+    nas_pkt_io_stats_get(stats);
+
+    printf("RX                      : %llu\n", (unsigned long long)stats->cnt[NAS_PKT_IO_CNT_RX]);
+    printf("RX (filtered)           : %llu\n", (unsigned long long)stats->cnt[NAS_PKT_IO_CNT_RX_FILTERED]);
+    printf("TX (total)              : %llu\n", (unsigned long long)stats->cnt[NAS_PKT_IO_CNT_TX]);
+    printf("TX (pipeline bypass)    : %llu\n", (unsigned long long)stats->cnt[NAS_PKT_IO_CNT_TX_BYPASS]);
+    printf("TX (pipeline lookup)    : %llu\n", (unsigned long long)stats->cnt[NAS_PKT_IO_CNT_TX_LOOKUP]);
+    printf("TX (lookup hybrid)      : %llu\n", (unsigned long long)stats->cnt[NAS_PKT_IO_CNT_TX_LOOKUP_HYBRID]);
+    printf("DROP RX (tap write)     : %llu\n", (unsigned long long)stats->drop[NAS_PKT_IO_DROP_RX_TAP]);
+    printf("DROP TX (ndi)           : %llu\n", (unsigned long long)stats->drop[NAS_PKT_IO_DROP_TX_NDI]);
+    printf("DROP TX (lookup ndi)    : %llu\n", (unsigned long long)stats->drop[NAS_PKT_IO_DROP_TX_LOOKUP_NDI]);
+    free(stats);
+    hal_virtual_interface_dbg_counters();
+
+    nas_sflow_export_stats_t sflow;
+    nas_sflow_export_stats_get(&sflow);
+    printf("SFLOW enqueued          : %llu\n", (unsigned long long)sflow.enqueued);
+    printf("SFLOW exported          : %llu\n", (unsigned long long)sflow.exported);
+    printf("SFLOW truncated         : %llu\n", (unsigned long long)sflow.truncated);
+    printf("SFLOW batches           : %llu\n", (unsigned long long)sflow.batches);
+    printf("SFLOW drop (overflow)   : %llu\n", (unsigned long long)sflow.drop_overflow);
+    printf("SFLOW drop (no port)    : %llu\n", (unsigned long long)sflow.drop_no_port);
+    printf("SFLOW drop (send error) : %llu\n", (unsigned long long)sflow.drop_send_err);
+    printf("SFLOW drop (not sent)   : %llu\n", (unsigned long long)sflow.drop_unsent);
 }
+static void pkt_debug_stats(std_parsed_string_t handle) {
+    size_t ix = 0;
+    const char *token = std_parse_string_next(handle, &ix);
+    if (token != NULL && !strcmp(token, "clear")) {
+        nas_pkt_io_stats_clear();
+        return;
+    }
+
+    nas_pkt_io_stats_t *stats = malloc(sizeof(*stats));
+    if (stats == NULL) return;
+    nas_pkt_io_stats_get(stats);
+
+    size_t npu;
+    printf("NPU PORT     RX               TX\n");
+    for (npu = 0; npu < NAS_PKT_IO_STATS_MAX_NPUS; ++npu) {
+        for (ix = 0; ix < NAS_PKT_IO_STATS_MAX_PORTS; ++ix) {
+            if (stats->port_rx[npu][ix] == 0 && stats->port_tx[npu][ix] == 0) continue;
+            printf("%-3lu %-8lu %-16llu %llu\n", npu, ix, (unsigned long long)stats->port_rx[npu][ix],
+                   (unsigned long long)stats->port_tx[npu][ix]);
+        }
+    }
+
+    printf("TRAP-ID              RX\n");
+    for (ix = 0; ix < stats->trap_count; ++ix) {
+        printf("%-20llu %llu\n", (unsigned long long)stats->trap[ix].trap_id,
+               (unsigned long long)stats->trap[ix].rx);
+    }
+    printf("%-20s %llu\n", "other", (unsigned long long)stats->trap_other_rx);
+
+    static const char *lat_names[NAS_PKT_IO_LAT_MAX] = {"RX to TAP", "TAP to NDI"};
+    size_t lat;
+    for (lat = 0; lat < NAS_PKT_IO_LAT_MAX; ++lat) {
+        printf("LATENCY %s (us)\n", lat_names[lat]);
+        for (ix = 0; ix < NAS_PKT_IO_LAT_BUCKETS; ++ix) {
+            if (stats->lat[lat][ix] == 0) continue;
+            if (ix == 0) printf("  <1          ");
+            else if (ix == NAS_PKT_IO_LAT_BUCKETS - 1) printf("  >=%-9lu ", 1UL << (ix - 1));
+            else printf("  %-5lu-%-5lu ", 1UL << (ix - 1), (1UL << ix) - 1);
+            printf("%llu\n", (unsigned long long)stats->lat[lat][ix]);
+        }
+    }
+    free(stats);
+}
+
 /*
  * Pthread variables
  */
@@ -104,26 +166,6 @@ static void hal_packet_io_dump(uint8_t *buf, int len, int pkt_dir)
     }
 }
 
-static int sflow_sock_fd = -1;
-static std_socket_address_t sflow_sock_dest;
-
-static void _sflow_sock_init ()
-{
-    t_std_error rc = std_socket_create (e_std_sock_INET4, e_std_sock_type_DGRAM,
-                                        0, NULL, &sflow_sock_fd);
-    if (rc != STD_ERR_OK) {
-        EV_LOGGING (NAS_PKT_IO, ERR, "SFlow", "socket Error %d", rc);
-    }
-    /* Set the SFlow pkt dest addr from default values. Will be made configurable in future */
-#define SFLOW_PKT_DEF_IP    "127.0.0.1"
-#define SFLOW_PKT_DEF_PORT   20001
-    rc = std_sock_addr_from_ip_str (e_std_sock_INET4, SFLOW_PKT_DEF_IP,
-                                    SFLOW_PKT_DEF_PORT, &sflow_sock_dest);
-    if (rc != STD_ERR_OK) {
-        EV_LOGGING (NAS_PKT_IO, ERR, "SFlow", "socket address creation error %d", rc);
-    }
-}
-
 static t_std_error _sflow_pkt_hdl (uint8_t *pkt, uint32_t pkt_len,
                                    const ndi_packet_attr_t *p_attr)
 {
@@ -133,6 +175,7 @@ static t_std_error _sflow_pkt_hdl (uint8_t *pkt, uint32_t pkt_len,
         EV_LOGGING (NAS_PKT_IO, DEBUG, "SFlow",
                  "Interface invalid - no matching port %d:%d",
                  p_attr->npu_id, p_attr->rx_port);
+        nas_sflow_export_drop_no_port ();
         return STD_ERR (INTERFACE, PARAM, 0);
     }
 
@@ -143,66 +186,11 @@ static t_std_error _sflow_pkt_hdl (uint8_t *pkt, uint32_t pkt_len,
     }
 
     EV_LOGGING (NAS_PKT_IO, DEBUG,"SFlow","Pkt received - length %d npu %d rx_ifindex %d"
-              " tx_ifindex %d sample count %lu\r\n",
-              pkt_len, p_attr->npu_id, rx_ifindex,tx_ifindex,sample_count);
-
-#define META_BUF_SIZE  1024
-    uint8_t meta_buf [META_BUF_SIZE];
-
-    nas_pkt_meta_attr_it_t it;
-    nas_pkt_meta_buf_init (meta_buf, sizeof(meta_buf), &it);
-    nas_pkt_meta_add_u32 (&it, NAS_PKT_META_RX_PORT, rx_ifindex);
-    nas_pkt_meta_add_u32 (&it, NAS_PKT_META_TX_PORT, tx_ifindex);
-
-    /* Increment the sample count and add it as meta data and if it reaches the max value of uint64_t
-     * it will start again from 0
-     */
-    nas_pkt_meta_add_u64 (&it, NAS_PKT_META_SAMPLE_COUNT, sample_count++);
-    nas_pkt_meta_add_u32 (&it, NAS_PKT_META_PKT_LEN, pkt_len);
-
-    // The length field in the iterator gives the remaining length left
-    // after filling all meta data attributes
-    size_t meta_len = sizeof(meta_buf) - it.len;
-    struct iovec sock_data[] = { {(char*)meta_buf, meta_len},
-                                {pkt, pkt_len} };
-
-    /* TODO - Avoid direct access to the global sflow sock dest addr
-     *  since we will add support to configure the global.
-     *  Will need to copy inet4addr into a local variable in future */
-    std_socket_msg_t sock_msg = { &sflow_sock_dest.address.inet4addr,
-            sizeof (sflow_sock_dest.address.inet4addr),
-            sock_data, sizeof (sock_data)/sizeof (sock_data[0]),
-            NULL, 0, 0};
-
-    t_std_error rc;
-    int n = std_socket_op (std_socket_transit_o_WRITE, sflow_sock_fd, &sock_msg,
-            std_socket_transit_f_NONE, 0, &rc);
-    if (n < 0) {
-        EV_LOGGING (NAS_PKT_IO, ERR, "SFlow",
-                "ForwardMsg to UDP socket %d FAILED - Error %d code (%d)\r\n",
-                sflow_sock_fd, rc, STD_ERR_EXT_PRIV(rc));
-    }
-
-    return rc;
-}
-
-static bool _extract_std_ipv4_sock_addr (const std_socket_address_t* in_saddr,
-                                         dn_ipv4_addr_t* out_ip, int *out_port)
-{
-    if (in_saddr->type != e_std_sock_INET4) return false;
-    *out_ip = in_saddr->address.inet4addr.sin_addr;
-    *out_port = ntohs (in_saddr->address.inet4addr.sin_port);
-    return true;
-}
+              " tx_ifindex %d\r\n",
+              pkt_len, p_attr->npu_id, rx_ifindex,tx_ifindex);
 
-static void _mk_std_ipv4_sock_addr (dn_ipv4_addr_t* ip, int port,
-                                    std_socket_address_t* out_saddr)
-{
-    out_saddr->address.inet4addr.sin_family = AF_INET;
-    out_saddr->address.inet4addr.sin_addr = *ip;
-    out_saddr->addr_type = e_std_socket_a_t_INET; // Common for all INET families
-    out_saddr->type = e_std_sock_INET4;
-    out_saddr->address.inet4addr.sin_port = htons (port);
+    /* sent to the sFlow agent by the exporter thread */
+    return nas_sflow_export_enqueue (pkt, pkt_len, rx_ifindex, tx_ifindex);
 }
 
 static cps_api_return_code_t _cps_api_read (void                 *context,
@@ -239,7 +227,7 @@ static cps_api_return_code_t _cps_api_read (void                 *context,
 
     dn_ipv4_addr_t ip;
     int port = 0;
-    _extract_std_ipv4_sock_addr (&sflow_sock_dest, &ip, &port);
+    nas_sflow_export_dest_get (&ip, &port);
 
     if (!cps_api_object_attr_add (obj, BASE_SFLOW_SOCKET_ADDRESS_IP, &ip, sizeof (ip))) {
         return cps_api_ret_code_ERR;
@@ -274,7 +262,7 @@ static cps_api_return_code_t _cps_api_write_int (void                         *c
 
     dn_ipv4_addr_t ip;
     int port = 0;
-    _extract_std_ipv4_sock_addr (&sflow_sock_dest, &ip, &port);
+    nas_sflow_export_dest_get (&ip, &port);
 
     bool dirty=false;
     cps_api_object_it_t  it;
@@ -310,7 +298,7 @@ static cps_api_return_code_t _cps_api_write_int (void                         *c
                 break;
         }
     }
-    if (dirty) _mk_std_ipv4_sock_addr (&ip, port, &sflow_sock_dest);
+    if (dirty) nas_sflow_export_dest_set (&ip, port);
     return cps_api_ret_code_OK;
 }
 
@@ -478,29 +466,39 @@ static t_std_error _cps_init ()
 
 static t_std_error dn_hal_packet_rx(uint8_t *pkt, uint32_t len, ndi_packet_attr_t *p_attr)
 {
-    ++packets_rxed;
+    uint64_t start = nas_pkt_io_stats_now();
+
+    nas_pkt_io_stats_inc(NAS_PKT_IO_CNT_RX, 1);
+    nas_pkt_io_stats_port_rx(p_attr->npu_id, p_attr->rx_port, p_attr->trap_id);
     if (PKT_DBG_DUMP(pkt_debug)) hal_packet_io_dump(pkt, len, PKT_DBG_DIR_IN);
 
     EV_LOGGING(NAS_PKT_IO, INFO, "RX",
-            "On npu %d port %d len %d, rx count:%d",
-            p_attr->npu_id, p_attr->rx_port, len, packets_rxed);
+            "On npu %d port %d len %d",
+            p_attr->npu_id, p_attr->rx_port, len);
 
     if (p_attr->trap_id == NDI_PACKET_TRAP_ID_SAMPLEPACKET)
         return _sflow_pkt_hdl (pkt, len, p_attr);
 
     if(nas_pf_ingr_enabled()) {
         bool stop = nas_pf_in_pkt_hndlr(pkt, len, p_attr);
-        if(stop) return (STD_ERR_OK);
+        if(stop) {
+            nas_pkt_io_stats_inc(NAS_PKT_IO_CNT_RX_FILTERED, 1);
+            return (STD_ERR_OK);
+        }
     }
 
-    t_std_error err = hal_virtual_interface_send(p_attr->npu_id,p_attr->rx_port,0,pkt,len);
+    /* spread the flows over the tap queues */
+    t_std_error err = hal_virtual_interface_send(p_attr->npu_id,p_attr->rx_port,-1,pkt,len);
 
-    if (err != STD_ERR_OK)
+    if (err != STD_ERR_OK) {
+        nas_pkt_io_stats_drop(NAS_PKT_IO_DROP_RX_TAP, 1);
         EV_LOGGING(NAS_PKT_IO, ERR, "RX",
                 "Failed to write data to fd %d", err);
-    else
+    } else {
+        nas_pkt_io_stats_latency(NAS_PKT_IO_LAT_RX_TO_TAP, start, 1);
         EV_LOGGING(NAS_PKT_IO, DEBUG, "RX",
                 "Data written to fd");
+    }
 
     return (STD_ERR_OK);
 }
@@ -509,8 +507,9 @@ static void dn_hal_packet_tx(npu_id_t npu, npu_port_t port, void  *pkt, uint32_t
 {
     ndi_packet_attr_t attr;
 
-    ++packets_txed;
-    ++packets_txed_to_pipeline_bypass;
+    nas_pkt_io_stats_inc(NAS_PKT_IO_CNT_TX, 1);
+    nas_pkt_io_stats_inc(NAS_PKT_IO_CNT_TX_BYPASS, 1);
+    nas_pkt_io_stats_port_tx(npu, port, 1);
 
     if (PKT_DBG_DUMP(pkt_debug)) hal_packet_io_dump(pkt, len, PKT_DBG_DIR_OUT);
 
@@ -525,18 +524,73 @@ static void dn_hal_packet_tx(npu_id_t npu, npu_port_t port, void  *pkt, uint32_t
     }
 
     if (ndi_packet_tx(pkt, len, &attr) != STD_ERR_OK) {
+        nas_pkt_io_stats_drop(NAS_PKT_IO_DROP_TX_NDI, 1);
         EV_LOGGING(NAS_PKT_IO, ERR, "TX",
                 "Pkt txmission FAILED for npu:%d, port:%d, len:%d",
                 npu, port, len);
 
     } else {
         EV_LOGGING(NAS_PKT_IO, INFO, "TX",
-                "Pkt txmission OK for npu %d port %d len %d, "
-                "tx count:%d",
-                npu, port, len, packets_txed_to_pipeline_bypass);
+                "Pkt txmission OK for npu %d port %d len %d",
+                npu, port, len);
     }
 }
 
+/*!
+ *  \brief     Function to transmit a burst of packets read from one kernel interface
+ *  \param[in] npu    The npu id the packets are sent on
+ *  \param[in] port   The npu port the packets are sent on
+ *  \param[in] pkts   The packets
+ *  \param[in] count  The number of packets
+ *  \sa dn_hal_packet_tx
+ */
+static void dn_hal_packet_tx_burst(npu_id_t npu, npu_port_t port, hal_virt_pkt_t *pkts, size_t count)
+{
+    ndi_packet_attr_t attr[count];
+    size_t ix, tx_ok = 0;
+
+    /* count the whole burst once */
+    nas_pkt_io_stats_inc(NAS_PKT_IO_CNT_TX, count);
+    nas_pkt_io_stats_inc(NAS_PKT_IO_CNT_TX_BYPASS, count);
+    nas_pkt_io_stats_port_tx(npu, port, count);
+
+    for (ix = 0; ix < count; ++ix) {
+        if (PKT_DBG_DUMP(pkt_debug)) hal_packet_io_dump(pkts[ix].data, pkts[ix].len, PKT_DBG_DIR_OUT);
+
+        attr[ix].npu_id  = npu;
+        attr[ix].tx_port = port;
+
+        /* regular packet tx flow is bypass tx pipeline */
+        attr[ix].tx_type = NDI_PACKET_TX_TYPE_PIPELINE_BYPASS;
+    }
+
+    if(nas_pf_egr_enabled()) {
+        uint8_t *bufs[count];
+        uint32_t lens[count];
+        for (ix = 0; ix < count; ++ix) {
+            bufs[ix] = pkts[ix].data;
+            lens[ix] = pkts[ix].len;
+        }
+        nas_pf_out_pkt_burst_hndlr(bufs, lens, attr, count);
+    }
+
+    /* NDI transmits one frame per call */
+    for (ix = 0; ix < count; ++ix) {
+        if (ndi_packet_tx(pkts[ix].data, pkts[ix].len, &attr[ix]) != STD_ERR_OK) {
+            EV_LOGGING(NAS_PKT_IO, ERR, "TX",
+                    "Pkt txmission FAILED for npu:%d, port:%d, len:%d",
+                    attr[ix].npu_id, attr[ix].tx_port, pkts[ix].len);
+        } else {
+            ++tx_ok;
+        }
+    }
+    if (tx_ok != count) nas_pkt_io_stats_drop(NAS_PKT_IO_DROP_TX_NDI, count - tx_ok);
+
+    EV_LOGGING(NAS_PKT_IO, INFO, "TX",
+            "Pkt burst txmission for npu %d port %d, %lu of %lu sent",
+            npu, port, tx_ok, count);
+}
+
 void dn_hal_packet_tx_to_ingress_pipeline (void  *pkt, uint32_t len)
 {
     npu_id_t npu;
@@ -547,8 +601,8 @@ void dn_hal_packet_tx_to_ingress_pipeline (void  *pkt, uint32_t len)
      */
     npu = 0;
 
-    ++packets_txed;
-    ++packets_txed_to_pipeline_lookup;
+    nas_pkt_io_stats_inc(NAS_PKT_IO_CNT_TX, 1);
+    nas_pkt_io_stats_inc(NAS_PKT_IO_CNT_TX_LOOKUP, 1);
 
     if (PKT_DBG_DUMP(pkt_debug)) hal_packet_io_dump(pkt, len, PKT_DBG_DIR_OUT);
 
@@ -559,14 +613,14 @@ void dn_hal_packet_tx_to_ingress_pipeline (void  *pkt, uint32_t len)
     attr.tx_type = NDI_PACKET_TX_TYPE_PIPELINE_LOOKUP;
 
     if (ndi_packet_tx (pkt, len, &attr) != STD_ERR_OK) {
+        nas_pkt_io_stats_drop(NAS_PKT_IO_DROP_TX_LOOKUP_NDI, 1);
         EV_LOGGING(NAS_PKT_IO, ERR, "TX-INGRESS",
                 "Pkt txmission to ingress pipeline FAILED for npu:%d, len:%d",
                 npu, len);
     } else {
         EV_LOGGING(NAS_PKT_IO, INFO, "TX-INGRESS",
-                "Pkt txmission to ingress pipeline OK for npu %d len %d, "
-                "tx-ingress-pipeline count:%d",
-                npu, len, packets_txed_to_pipeline_lookup);
+                "Pkt txmission to ingress pipeline OK for npu %d len %d",
+                npu, len);
     }
 }
 
@@ -580,8 +634,8 @@ void dn_hal_packet_tx_to_ingress_pipeline_hybrid (void  *pkt, uint32_t len, ndi_
      */
     npu = 0;
 
-    ++packets_txed;
-    ++packets_txed_to_pipeline_lookup_hybrid;
+    nas_pkt_io_stats_inc(NAS_PKT_IO_CNT_TX, 1);
+    nas_pkt_io_stats_inc(NAS_PKT_IO_CNT_TX_LOOKUP_HYBRID, 1);
 
     if (PKT_DBG_DUMP(pkt_debug)) hal_packet_io_dump(pkt, len, PKT_DBG_DIR_OUT);
 
@@ -592,14 +646,14 @@ void dn_hal_packet_tx_to_ingress_pipeline_hybrid (void  *pkt, uint32_t len, ndi_
     attr.bridge_id = obj_id;
 
     if (ndi_packet_tx (pkt, len, &attr) != STD_ERR_OK) {
+        nas_pkt_io_stats_drop(NAS_PKT_IO_DROP_TX_LOOKUP_NDI, 1);
         EV_LOGGING(NAS_PKT_IO, ERR, "TX-INGRESS-HYBRID",
                 "Pkt txmission to ingress pipeline hybrid FAILED for npu:%d, len:%d",
                 npu, len);
     } else {
         EV_LOGGING(NAS_PKT_IO, INFO, "TX-INGRESS-HYBRID",
-                "Pkt txmission to ingress pipeline hybrid OK for npu %d len %d, "
-                "tx-ingress-pipeline-hybrid:%d",
-                npu, len, packets_txed_to_pipeline_lookup_hybrid);
+                "Pkt txmission to ingress pipeline hybrid OK for npu %d len %d",
+                npu, len);
     }
 }
 
@@ -635,6 +689,7 @@ t_std_error hal_packet_io_main(void) {
      * call to hal_virtual_interface_wait() trigger event dispatcher.
      */
     if (hal_virtual_interface_wait(dn_hal_packet_tx,
+                                   dn_hal_packet_tx_burst,
                                    dn_hal_packet_tx_to_ingress_pipeline,
                                    dn_hal_packet_tx_to_ingress_pipeline_hybrid,
                                    pkt_buf,MAX_PKT_LEN)!=STD_ERR_OK) {
@@ -657,8 +712,8 @@ t_std_error hal_packet_io_init(void)
 
     pthread_setname_np(packet_io_thr, "hal_packet_io");
 
-    /* Create socket to send SFLOW sample packet */
-    _sflow_sock_init ();
+    /* Start the export of SFLOW sample packets */
+    nas_sflow_export_init ();
     nas_pf_initialize();
     _cps_init ();
 
@@ -666,6 +721,7 @@ t_std_error hal_packet_io_init(void)
 
     hal_shell_cmd_add("pkt-io-debug",change_debug_flag_state,"[true|false] [in|out|both] Changes Debug flag state\nWarning: Enabling this will generate lots of information and may impact the performance");
     hal_shell_cmd_add("pkt-io-counters",pkt_debug_counters,"Displays Packet count");
+    hal_shell_cmd_add("pkt-io-stats",pkt_debug_stats,"[clear] Displays per port/trap packet counts and latency, or clears the packet statistics");
 
     return STD_ERR_OK;
 }
@@ -65,6 +65,11 @@
 #include <inttypes.h>
 #include <unordered_map>
 #include <list>
+#include <vector>
+#include <algorithm>
+#include <pthread.h>
+#include <mutex>
+#include <chrono>
 
 struct _npu_port_t {
     uint_t npu_id;
@@ -128,6 +133,35 @@ using NasLogicalPortMap = std::unordered_map<_npu_port_t, _port_cache, _npu_port
 static NasLogicalPortMap _logical_port_tbl;
 static std_rw_lock_t _logical_port_lock;
 
+/*
+ * NPU state attributes of the mapped ports returned by interfaces-state gets.
+ * An entry is read from the NPU on the first get, dropped when the port
+ * changes (link event, attribute set, port delete) and read again once it is
+ * older than the TTL, which covers changes the NAS is not told about.
+ */
+#define NAS_PORT_STATE_CACHE_TTL_MS 5000
+
+struct _port_state_cache {
+    cps_api_object_t obj = nullptr;
+    std::chrono::steady_clock::time_point filled;
+    uint64_t gen = 0;       // bumped by every invalidate
+};
+
+using NasPortStateMap = std::unordered_map<_npu_port_t, _port_state_cache, _npu_port_hash_t>;
+static NasPortStateMap _port_state_tbl;
+static std::mutex _port_state_lock;
+
+static void _port_state_cache_invalidate(npu_id_t npu, port_t port) {
+    _npu_port_t npu_port = {(uint_t)npu, (uint_t)port};
+    std::lock_guard<std::mutex> g(_port_state_lock);
+    _port_state_cache& ent = _port_state_tbl[npu_port];
+    if (ent.obj != nullptr) {
+        cps_api_object_delete(ent.obj);
+        ent.obj = nullptr;
+    }
+    ++ent.gen;
+}
+
 static auto _error_string_map_table = new std::unordered_map<int, std::string>
 {
     /* For Error ID's in PRIV object, map SAI Error code to STD Error Codes
@@ -145,6 +179,7 @@ static void set_cps_obj_return_attrs(cps_api_object_t obj, t_std_error rc,
                                      cps_api_attr_id_t attr);
 
 static t_std_error _logical_port_tbl_delete(npu_id_t npu,port_t port){
+    _port_state_cache_invalidate(npu, port);
     _npu_port_t npu_port = {(uint_t)npu, (uint_t)port};
     std_rw_lock_write_guard g(&_logical_port_lock);
     auto it = _logical_port_tbl.find(npu_port);
@@ -418,6 +453,62 @@ static cps_api_return_code_t if_cpu_port_set(void * context, cps_api_transaction
     return cps_api_ret_code_ERR;
 }
 
+/* NAS information of an interface dumped from the OS, false if NAS doesn't know it */
+static bool _if_info_from_os_obj(cps_api_object_t object, interface_ctrl_t& _port) {
+
+    cps_api_object_attr_t ifix = cps_api_object_attr_get(object,DELL_BASE_IF_CMN_IF_INTERFACES_INTERFACE_IF_INDEX);
+    if (ifix == nullptr) {
+        EV_LOGGING(INTERFACE, ERR, "NAS-INT-GET", "Ifindex not found in object");
+        return false;
+    }
+    memset(&_port,0,sizeof(_port));
+    _port.if_index = cps_api_object_attr_data_u32(ifix);
+    _port.q_type = HAL_INTF_INFO_FROM_IF;
+    return dn_hal_get_interface_info(&_port)==STD_ERR_OK;
+}
+
+static void _if_fill_in_port_attrs(cps_api_object_t object, const interface_ctrl_t& _port,
+                                   const char *if_type) {
+
+    cps_api_key_from_attr_with_qual(cps_api_object_key(object), DELL_BASE_IF_CMN_IF_INTERFACES_INTERFACE_OBJ,
+            cps_api_qualifier_TARGET);
+    cps_api_object_attr_add(object,IF_INTERFACES_INTERFACE_TYPE,
+                                    (const void *)if_type, strlen(if_type)+1);
+
+    if (_port.port_mapped) {
+        cps_api_object_attr_add_u32(object,BASE_IF_PHY_IF_INTERFACES_INTERFACE_NPU_ID,_port.npu_id);
+        cps_api_object_attr_add_u32(object,BASE_IF_PHY_IF_INTERFACES_INTERFACE_PORT_ID,_port.port_id);
+
+        bool state = false;
+        nas_intf_admin_state_get(_port.if_index, &state);
+        cps_api_object_attr_delete(object,IF_INTERFACES_INTERFACE_ENABLED);
+        cps_api_object_attr_add_u32(object,IF_INTERFACES_INTERFACE_ENABLED, state);
+
+        if (_port.int_type == nas_int_type_FC) {
+            nas_fc_fill_intf_attr(_port.npu_id, _port.port_id, object);
+        } else {
+            _if_fill_in_npu_attrs(_port.npu_id, _port.port_id, _port.int_type, object);
+        }
+    }
+
+    if (_port.desc) {
+        cps_api_object_attr_add(object, IF_INTERFACES_INTERFACE_DESCRIPTION,
+                                    (const void*)_port.desc, strlen(_port.desc) + 1);
+    }
+
+    if (_port.port_mapped) {
+        _npu_port_t npu_port = {(uint_t)_port.npu_id, (uint_t)_port.port_id};
+        std_rw_lock_read_guard g(&_logical_port_lock);
+        auto it = _logical_port_tbl.find(npu_port);
+        if (it != _logical_port_tbl.end()) {
+            cps_api_object_attr_add_u32(object, DELL_IF_IF_INTERFACES_INTERFACE_MODE,
+                    it->second.mode);
+            cps_api_object_attr_add_u32(object, BASE_IF_PHY_IF_INTERFACES_INTERFACE_PHY_MEDIA,
+                    it->second.media_type);
+        }
+    }
+}
+
 static cps_api_return_code_t if_get (void * context, cps_api_get_params_t * param,
         size_t key_ix) {
 
@@ -450,85 +541,39 @@ static cps_api_return_code_t if_get (void * context, cps_api_get_params_t * para
         EV_LOGGING(INTERFACE, ERR, "NAS-INT-GET", "Failed to get interfaces from OS");
         return cps_api_ret_code_ERR;
     }
-    size_t mx = cps_api_object_list_size(param->list);
-    char if_type[256];
-    size_t ix = 0;
-    while (ix < mx) {
-        cps_api_object_t object = cps_api_object_list_get(param->list,ix);
-        cps_api_object_attr_t ifix = cps_api_object_attr_get(object,DELL_BASE_IF_CMN_IF_INTERFACES_INTERFACE_IF_INDEX);
-        cps_api_key_from_attr_with_qual(cps_api_object_key(object), DELL_BASE_IF_CMN_IF_INTERFACES_INTERFACE_OBJ,
-                cps_api_qualifier_TARGET);
+    bool type_err = false;
+    nas_intf_obj_list_filter(param->list, [&](cps_api_object_t object) {
         interface_ctrl_t _port;
-        if (ifix != nullptr) {
-            memset(&_port,0,sizeof(_port));
-            _port.if_index = cps_api_object_attr_data_u32(ifix);
-            _port.q_type = HAL_INTF_INFO_FROM_IF;
-            if(dn_hal_get_interface_info(&_port)==STD_ERR_OK) {
-                if (!nas_to_ietf_if_type_get(_port.int_type, if_type, sizeof(if_type))) {
-                    EV_LOGGING(INTERFACE, ERR, "NAS-INT-GET", "Failed to get IETF interface type for type id %d",
-                               _port.int_type);
-                    return cps_api_ret_code_ERR;
-                }
-                // TODO revisit the logic since this handler is always expecting interface type in the  get call
-                if (have_type_filter) {
-                    if(strncmp(if_type,req_if_type, sizeof(if_type)) != 0) {
-                        cps_api_object_list_remove(param->list,ix);
-                        cps_api_object_delete(object);
-                        --mx;
-                        continue;
-                    }
-                }
-                cps_api_object_attr_add(object,IF_INTERFACES_INTERFACE_TYPE,
-                                                (const void *)if_type, strlen(if_type)+1);
-
-                if (_port.port_mapped) {
-                    cps_api_object_attr_add_u32(object,BASE_IF_PHY_IF_INTERFACES_INTERFACE_NPU_ID,_port.npu_id);
-                    cps_api_object_attr_add_u32(object,BASE_IF_PHY_IF_INTERFACES_INTERFACE_PORT_ID,_port.port_id);
-
-                    bool state = false;
-                    nas_intf_admin_state_get(_port.if_index, &state);
-                    cps_api_object_attr_delete(object,IF_INTERFACES_INTERFACE_ENABLED);
-                    cps_api_object_attr_add_u32(object,IF_INTERFACES_INTERFACE_ENABLED, state);
-
-                    if (_port.int_type == nas_int_type_FC) {
-                        nas_fc_fill_intf_attr(_port.npu_id, _port.port_id, object);
-                    } else {
-                        _if_fill_in_npu_attrs(_port.npu_id, _port.port_id, _port.int_type, object);
-                    }
-                }
+        if (type_err || !_if_info_from_os_obj(object, _port)) return false;
 
-                if (_port.desc) {
-                    cps_api_object_attr_add(object, IF_INTERFACES_INTERFACE_DESCRIPTION,
-                                                (const void*)_port.desc, strlen(_port.desc) + 1);
-                }
-
-            } else {
-                ifix = nullptr;    //use to indicate that we want to erase this entry
-            }
-        } else {
-            EV_LOGGING(INTERFACE, ERR, "NAS-INT-GET", "Ifindex not found in object");
-        }
-        if (ifix != nullptr && _port.port_mapped) {
-            _npu_port_t npu_port = {(uint_t)_port.npu_id, (uint_t)_port.port_id};
-            std_rw_lock_read_guard g(&_logical_port_lock);
-            auto it = _logical_port_tbl.find(npu_port);
-            if (it != _logical_port_tbl.end()) {
-                cps_api_object_attr_add_u32(object, DELL_IF_IF_INTERFACES_INTERFACE_MODE,
-                        it->second.mode);
-                cps_api_object_attr_add_u32(object, BASE_IF_PHY_IF_INTERFACES_INTERFACE_PHY_MEDIA,
-                        it->second.media_type);
-            }
-        }
-        if (ifix==nullptr) {
-            cps_api_object_list_remove(param->list,ix);
-            cps_api_object_delete(object);
-            --mx;
-            continue;
+        char if_type[256];
+        if (!nas_to_ietf_if_type_get(_port.int_type, if_type, sizeof(if_type))) {
+            EV_LOGGING(INTERFACE, ERR, "NAS-INT-GET", "Failed to get IETF interface type for type id %d",
+                       _port.int_type);
+            type_err = true;
+            return false;
         }
-        ++ix;
-    }
+        // TODO revisit the logic since this handler is always expecting interface type in the  get call
+        if (have_type_filter && strncmp(if_type,req_if_type, sizeof(if_type)) != 0) return false;
 
-    return cps_api_ret_code_OK;
+        _if_fill_in_port_attrs(object, _port, if_type);
+        return true;
+    });
+
+    return type_err ? cps_api_ret_code_ERR : cps_api_ret_code_OK;
+}
+
+/* Wildcard get, object is an OS interface of type PORT or FC */
+static bool if_fill (void * context, cps_api_object_t object, const interface_ctrl_t *intf) {
+
+    char if_type[256];
+    if (!nas_to_ietf_if_type_get(intf->int_type, if_type, sizeof(if_type))) {
+        EV_LOGGING(INTERFACE, ERR, "NAS-INT-GET", "Failed to get IETF interface type for type id %d",
+                   intf->int_type);
+        return false;
+    }
+    _if_fill_in_port_attrs(object, *intf, if_type);
+    return true;
 }
 
 static void _if_fill_in_npu_intf_state(npu_id_t npu_id, npu_port_t port_id, nas_int_type_t int_type,
@@ -576,6 +621,82 @@ static void _if_fill_in_npu_intf_state(npu_id_t npu_id, npu_port_t port_id, nas_
     }
 }
 
+static void _if_fill_in_port_npu_state(npu_id_t npu, port_t port, nas_int_type_t int_type,
+                                       cps_api_object_t obj) {
+    _if_fill_in_npu_intf_state(npu, port, int_type, obj);
+    _if_fill_in_supported_speeds_attrs(npu, port, int_type, obj);
+    _if_fill_in_eee_attrs(npu, port, obj);
+    _if_fill_in_npu_speed_attr(npu, port, int_type, obj);
+    _if_fill_in_supported_autoneg_attr(npu, port, obj);
+    _if_fill_in_max_speed_attr(npu, port, obj);
+}
+
+static void _if_copy_attrs(cps_api_object_t dst, cps_api_object_t src) {
+    cps_api_object_it_t it;
+    cps_api_object_it_begin(src, &it);
+    for ( ; cps_api_object_it_valid(&it) ; cps_api_object_it_next(&it)) {
+        cps_api_object_attr_add(dst, cps_api_object_attr_id(it.attr),
+                                cps_api_object_attr_data_bin(it.attr), cps_api_object_attr_len(it.attr));
+    }
+}
+
+/* NPU state of a port from the state cache, read from the NPU if not cached or too old */
+static void _if_fill_in_port_npu_state_cached(npu_id_t npu, port_t port, nas_int_type_t int_type,
+                                              cps_api_object_t obj) {
+    _npu_port_t npu_port = {(uint_t)npu, (uint_t)port};
+    auto now = std::chrono::steady_clock::now();
+    uint64_t gen = 0;
+    {
+        std::lock_guard<std::mutex> g(_port_state_lock);
+        _port_state_cache& ent = _port_state_tbl[npu_port];
+        if (ent.obj != nullptr &&
+            now - ent.filled < std::chrono::milliseconds(NAS_PORT_STATE_CACHE_TTL_MS)) {
+            _if_copy_attrs(obj, ent.obj);
+            return;
+        }
+        gen = ent.gen;
+    }
+
+    // NPU reads without the lock, gets of other ports go on meanwhile
+    cps_api_object_t state = cps_api_object_create();
+    if (state == nullptr) {
+        _if_fill_in_port_npu_state(npu, port, int_type, obj);
+        return;
+    }
+    _if_fill_in_port_npu_state(npu, port, int_type, state);
+    _if_copy_attrs(obj, state);
+
+    std::lock_guard<std::mutex> g(_port_state_lock);
+    _port_state_cache& ent = _port_state_tbl[npu_port];
+    if (ent.gen != gen) {
+        // The port changed while it was read, don't keep what may be old
+        cps_api_object_delete(state);
+        return;
+    }
+    if (ent.obj != nullptr) cps_api_object_delete(ent.obj);
+    ent.obj = state;
+    ent.filled = now;
+}
+
+static void _if_fill_in_port_state_attrs(cps_api_object_t object, const interface_ctrl_t& _port,
+                                         const char *if_type) {
+
+    cps_api_key_from_attr_with_qual(cps_api_object_key(object), DELL_BASE_IF_CMN_IF_INTERFACES_STATE_INTERFACE_OBJ,
+            cps_api_qualifier_OBSERVED);
+    cps_api_set_key_data(object,IF_INTERFACES_STATE_INTERFACE_NAME,
+                   cps_api_object_ATTR_T_BIN, _port.if_name, strlen(_port.if_name)+1);
+    if (_port.port_mapped) {
+        _if_fill_in_port_npu_state_cached(_port.npu_id, _port.port_id, _port.int_type, object);
+    }
+    /*  Add if index with right key */
+    cps_api_object_attr_add_u32(object,IF_INTERFACES_STATE_INTERFACE_IF_INDEX,
+                     _port.if_index);
+    cps_api_object_attr_delete(object, DELL_BASE_IF_CMN_IF_INTERFACES_INTERFACE_IF_INDEX);
+    cps_api_object_attr_delete(object, IF_INTERFACES_INTERFACE_NAME);
+    cps_api_object_attr_add(object,IF_INTERFACES_STATE_INTERFACE_TYPE,
+                                    (const void *)if_type, strlen(if_type)+1);
+}
+
 //TODO merge if_get and if_state_get in a common implementation
 static cps_api_return_code_t if_state_get (void * context, cps_api_get_params_t * param,
         size_t key_ix) {
@@ -615,67 +736,39 @@ static cps_api_return_code_t if_state_get (void * context, cps_api_get_params_t
         return cps_api_ret_code_ERR;
     }
 
-    size_t mx = cps_api_object_list_size(param->list);
-    char if_type[256];
-    size_t ix = 0;
-    while (ix < mx) {
-        cps_api_object_t object = cps_api_object_list_get(param->list,ix);
-        cps_api_object_attr_t ifix = cps_api_object_attr_get(object, DELL_BASE_IF_CMN_IF_INTERFACES_INTERFACE_IF_INDEX);
-        cps_api_key_from_attr_with_qual(cps_api_object_key(object), DELL_BASE_IF_CMN_IF_INTERFACES_STATE_INTERFACE_OBJ,
-                cps_api_qualifier_OBSERVED);
-        /*  TODO If if_index not present then extract from name */
+    bool type_err = false;
+    nas_intf_obj_list_filter(param->list, [&](cps_api_object_t object) {
         interface_ctrl_t _port;
-        memset(&_port,0,sizeof(_port));
-        if (ifix!=NULL) {
-            _port.if_index = cps_api_object_attr_data_u32(ifix);
-            _port.q_type = HAL_INTF_INFO_FROM_IF;
-            if(dn_hal_get_interface_info(&_port)==STD_ERR_OK) {
-                if (!nas_to_ietf_if_type_get(_port.int_type, if_type, sizeof(if_type))) {
-                    EV_LOGGING(INTERFACE, ERR, "NAS-INT-GET", "Failed to get IETF interface type for type id %d",
-                               _port.int_type);
-                    return cps_api_ret_code_ERR;
-                }
-                // TODO revisit the logic since this handler is always expecting interface type in the  get call
-                if (have_type_filter) {
-                    if(strncmp(if_type,req_if_type, sizeof(if_type)) != 0) {
-                        cps_api_object_list_remove(param->list,ix);
-                        cps_api_object_delete(object);
-                        --mx;
-                        continue;
-                    }
-                }
-                cps_api_set_key_data(object,IF_INTERFACES_STATE_INTERFACE_NAME,
-                               cps_api_object_ATTR_T_BIN, _port.if_name, strlen(_port.if_name)+1);
-                if (_port.port_mapped) {
-                    _if_fill_in_npu_intf_state(_port.npu_id, _port.port_id, _port.int_type, object);
-                    _if_fill_in_supported_speeds_attrs(_port.npu_id,_port.port_id, _port.int_type, object);
-                    _if_fill_in_eee_attrs(_port.npu_id,_port.port_id,object);
-                    _if_fill_in_npu_speed_attr(_port.npu_id,_port.port_id, _port.int_type, object);
-                    _if_fill_in_supported_autoneg_attr(_port.npu_id,_port.port_id, object);
-                    _if_fill_in_max_speed_attr(_port.npu_id, _port.port_id, object);
-                }
-                /*  Add if index with right key */
-                cps_api_object_attr_add_u32(object,IF_INTERFACES_STATE_INTERFACE_IF_INDEX,
-                                 _port.if_index);
-                cps_api_object_attr_delete(object, DELL_BASE_IF_CMN_IF_INTERFACES_INTERFACE_IF_INDEX);
-                cps_api_object_attr_delete(object, IF_INTERFACES_INTERFACE_NAME);
-                cps_api_object_attr_add(object,IF_INTERFACES_STATE_INTERFACE_TYPE,
-                                                (const void *)if_type, strlen(if_type)+1);
+        if (type_err || !_if_info_from_os_obj(object, _port)) return false;
 
-            } else {
-                ifix = nullptr;    //use to indicate that we want to erase this entry
-            }
-        }
-        if (ifix==nullptr) {
-            cps_api_object_list_remove(param->list,ix);
-            cps_api_object_delete(object);
-            --mx;
-            continue;
+        char if_type[256];
+        if (!nas_to_ietf_if_type_get(_port.int_type, if_type, sizeof(if_type))) {
+            EV_LOGGING(INTERFACE, ERR, "NAS-INT-GET", "Failed to get IETF interface type for type id %d",
+                       _port.int_type);
+            type_err = true;
+            return false;
         }
-        ++ix;
-    }
+        // TODO revisit the logic since this handler is always expecting interface type in the  get call
+        if (have_type_filter && strncmp(if_type,req_if_type, sizeof(if_type)) != 0) return false;
 
-    return cps_api_ret_code_OK;
+        _if_fill_in_port_state_attrs(object, _port, if_type);
+        return true;
+    });
+
+    return type_err ? cps_api_ret_code_ERR : cps_api_ret_code_OK;
+}
+
+/* Wildcard get, object is an OS interface of type PORT or FC */
+static bool if_state_fill (void * context, cps_api_object_t object, const interface_ctrl_t *intf) {
+
+    char if_type[256];
+    if (!nas_to_ietf_if_type_get(intf->int_type, if_type, sizeof(if_type))) {
+        EV_LOGGING(INTERFACE, ERR, "NAS-INT-GET", "Failed to get IETF interface type for type id %d",
+                   intf->int_type);
+        return false;
+    }
+    _if_fill_in_port_state_attrs(object, *intf, if_type);
+    return true;
 }
 
 static cps_api_return_code_t if_state_set(void * context, cps_api_transaction_params_t * param,size_t ix) {
@@ -1298,6 +1391,7 @@ static void if_rollback(cps_api_object_t rollback,interface_ctrl_t _port) {
         EV_LOGGING(INTERFACE, INFO, "NAS-IF-REG", "Calling rollback attribute %s for interface %s",
                    func->second.second, _port.if_name);
         cps_api_return_code_t ret = func->second.first(_port.npu_id,_port.port_id,rollback);
+        _port_state_cache_invalidate(_port.npu_id,_port.port_id);
         if (ret!=cps_api_ret_code_OK)
             EV_LOGGING(INTERFACE,ERR,"NAS-IF-REG","Failed to rollback Attribute %s for interface %s",
                        func->second.second, _port.if_name);
@@ -1521,6 +1615,7 @@ static cps_api_return_code_t _if_update(cps_api_object_t req_if, cps_api_object_
             EV_LOGGING(INTERFACE, INFO, "NAS-IF-REG", "Set attribute %s (%" PRId64 ") for interface %s",
                        func->second.second, id, _port.if_name);
             ret = func->second.first(_port.npu_id,_port.port_id,req_if);
+            _port_state_cache_invalidate(_port.npu_id,_port.port_id);
             if (ret!=cps_api_ret_code_OK) {
                 if (!(if_set) && (id == DELL_IF_IF_INTERFACES_INTERFACE_SPEED ||
                         id == DELL_IF_IF_INTERFACES_INTERFACE_FEC ||
@@ -1644,6 +1739,12 @@ static void if_add_tracker_for_reload(cps_api_object_t cur, bool mapped, npu_id_
     } else {
         snprintf(alias,sizeof(alias),"NAS##");
     }
+    //Interfaces found in the OS at startup already carry the alias
+    cps_api_object_attr_t cur_alias = cps_api_object_attr_get(cur,NAS_OS_IF_ALIAS);
+    if (cur_alias != nullptr) {
+        const char *data = (const char *)cps_api_object_attr_data_bin(cur_alias);
+        if (std::string(data, strnlen(data, cps_api_object_attr_len(cur_alias))) == alias) return;
+    }
     cps_api_object_attr_add(cur,NAS_OS_IF_ALIAS,alias,strlen(alias)+1);
     nas_os_interface_set_attribute(cur,NAS_OS_IF_ALIAS);
 }
@@ -1850,6 +1951,7 @@ static void nas_int_oper_state_cb(npu_id_t npu, npu_port_t port,
     EV_LOGGING(INTERFACE,INFO,
                "NAS-INTF-EVENT","Entering interface state change callback: npu %d port %d status %d",
                npu, port, status);
+    _port_state_cache_invalidate(npu, port);
     if (dn_hal_get_interface_info(&_port)!=STD_ERR_OK) {
         EV_LOGGING(INTERFACE, INFO, "NAS-INTF-EVENT", "Interface info not found for npu %d port %d",
                    npu, port);
@@ -1889,6 +1991,31 @@ static void nas_int_oper_state_cb(npu_id_t npu, npu_port_t port,
     hal_interface_send_event(obj);
 }
 
+/* Threads setting up the taps of the interfaces found in the OS at startup */
+#define NAS_INT_RESYNC_TAP_WORKERS 8
+
+/* Interfaces of a tap worker, ports of the same npu are kept together */
+typedef struct _nas_int_resync_part_t {
+    std::vector<cps_api_object_t> objs;
+    size_t tap_fail = 0;
+} nas_int_resync_part_t;
+
+static void *_resync_tap_worker(void *arg) {
+    nas_int_resync_part_t *part = (nas_int_resync_part_t *)arg;
+    for (auto cur : part->objs) {
+        cps_api_object_attr_t _name = cps_api_object_attr_get(cur,IF_INTERFACES_INTERFACE_NAME);
+        if (nas_int_port_tap_prepare((const char *)cps_api_object_attr_data_bin(_name)) != STD_ERR_OK) {
+            ++part->tap_fail;
+        }
+    }
+    return nullptr;
+}
+
+static inline uint64_t _resync_ms_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+}
+
 static void resync_with_os() {
     cps_api_object_list_guard lg(cps_api_object_list_create());
     cps_api_object_guard og(cps_api_object_create());
@@ -1897,9 +2024,17 @@ static void resync_with_os() {
         return ;
     }
 
+    auto start = std::chrono::steady_clock::now();
     if (nas_os_get_interface(og.get(),lg.get())!=STD_ERR_OK) {
         return ;
     }
+    uint64_t dump_ms = _resync_ms_since(start);
+
+    /* The taps are set up in parallel, partitioned by npu; the port table
+     * updates and NDI programming of _if_create stay serial */
+    std::vector<cps_api_object_t> objs;
+    std::vector<std::pair<npu_id_t, cps_api_object_t>> by_npu;
+    const npu_id_t unmapped_npu = -1;
 
     size_t ix = 0;
     size_t mx = cps_api_object_list_size(lg.get());
@@ -1918,18 +2053,60 @@ static void resync_with_os() {
         if (!if_get_tracker_details(cur, mapped, npu, port)) {
             continue;
         }
-        cps_api_object_guard prev(cps_api_object_create());
-        if(!prev.valid()) continue;
 
         if (mapped) {
             cps_api_object_attr_add_u32(cur,BASE_IF_PHY_IF_INTERFACES_INTERFACE_NPU_ID, npu);
             cps_api_object_attr_add_u32(cur,BASE_IF_PHY_IF_INTERFACES_INTERFACE_PORT_ID,port);
         }
+        by_npu.push_back(std::make_pair(mapped ? npu : unmapped_npu, cur));
+        objs.push_back(cur);
+    }
+
+    std::stable_sort(by_npu.begin(), by_npu.end(),
+                     [](const std::pair<npu_id_t, cps_api_object_t>& a,
+                        const std::pair<npu_id_t, cps_api_object_t>& b) { return a.first < b.first; });
+    std::vector<nas_int_resync_part_t> parts(std::min<size_t>(NAS_INT_RESYNC_TAP_WORKERS, by_npu.size()));
+    for (size_t o_ix = 0; o_ix < by_npu.size(); ++o_ix) {
+        parts[o_ix * parts.size() / by_npu.size()].objs.push_back(by_npu[o_ix].second);
+    }
+
+    start = std::chrono::steady_clock::now();
+    std::vector<pthread_t> workers;
+    for (auto& part : parts) {
+        pthread_t thr;
+        //With a single partition, or if no thread can be started, set up the taps here
+        if (parts.size() == 1 || pthread_create(&thr, NULL, _resync_tap_worker, &part) != 0) {
+            _resync_tap_worker(&part);
+            continue;
+        }
+        workers.push_back(thr);
+    }
+    for (auto thr : workers) pthread_join(thr, NULL);
+    uint64_t tap_ms = _resync_ms_since(start);
+
+    size_t created = 0, tap_fail = 0;
+    start = std::chrono::steady_clock::now();
+    for (auto cur : objs) {
+        cps_api_object_guard prev(cps_api_object_create());
+        if(!prev.valid()) continue;
 
         if (_if_create(cur,prev.get())!=cps_api_ret_code_OK) {
-            EV_LOGGING(INTERFACE,ERR,"NAS-INT-RELOAD", "Reload failed for %d:%d",(int)npu,(int)port);
+            EV_LOGGING(INTERFACE,ERR,"NAS-INT-RELOAD", "Reload failed for %s",
+                       (const char *)cps_api_object_attr_data_bin(
+                               cps_api_object_attr_get(cur,IF_INTERFACES_INTERFACE_NAME)));
+            continue;
         }
+        ++created;
     }
+    for (auto& part : parts) tap_fail += part.tap_fail;
+    uint64_t ndi_ms = _resync_ms_since(start);
+    nas_int_port_tap_prepare_clear();
+
+    EV_LOGGING(INTERFACE,NOTICE,"NAS-INT-RELOAD",
+               "Resync of %lu interfaces on %lu partitions (%lu failed, %lu tap failures): "
+               "os dump %llu ms, tap create %llu ms, ndi program %llu ms",
+               created, parts.size(), objs.size() - created, tap_fail, (unsigned long long)dump_ms,
+               (unsigned long long)tap_ms, (unsigned long long)ndi_ms);
 }
 
 static t_std_error _nas_int_npu_port_init(void) {
@@ -2027,6 +2204,15 @@ t_std_error nas_int_logical_init(cps_api_operation_handle_t handle)  {
         EV_LOGGING(INTERFACE,ERR,"NAS-INT-INIT", "Failed to register FC PHY interface state CPS handler");
         return STD_ERR(INTERFACE,FAIL,0);
     }
+
+    /*  PORT and FC interfaces of a get all come from one OS interface dump */
+    if (intf_obj_fill_registration(obj_INTF, nas_int_type_PORT, if_fill) != STD_ERR_OK ||
+        intf_obj_fill_registration(obj_INTF, nas_int_type_FC, if_fill) != STD_ERR_OK ||
+        intf_obj_fill_registration(obj_INTF_STATE, nas_int_type_PORT, if_state_fill) != STD_ERR_OK ||
+        intf_obj_fill_registration(obj_INTF_STATE, nas_int_type_FC, if_state_fill) != STD_ERR_OK) {
+        EV_LOGGING(INTERFACE,ERR,"NAS-INT-INIT", "Failed to register PHY interface fill handler");
+        return STD_ERR(INTERFACE,FAIL,0);
+    }
     /*  register interface get set for CPU port */
     if (intf_obj_handler_registration(obj_INTF, nas_int_type_CPU, if_cpu_port_get, if_cpu_port_set) != STD_ERR_OK) {
         EV_LOGGING(INTERFACE,ERR,"NAS-INT-INIT", "Failed to register CPU interface CPS handler");
@@ -2036,9 +2222,12 @@ t_std_error nas_int_logical_init(cps_api_operation_handle_t handle)  {
     nas_int_oper_state_register_cb(nas_int_oper_state_cb);
 
     t_std_error rc;
+    auto start = std::chrono::steady_clock::now();
     if ((rc=_nas_int_npu_port_init())!=STD_ERR_OK) {
         return rc;
     }
+    EV_LOGGING(INTERFACE,NOTICE,"NAS-INT-RELOAD", "CPU ports created and published in %llu ms",
+               (unsigned long long)_resync_ms_since(start));
 
     return STD_ERR_OK;
 }
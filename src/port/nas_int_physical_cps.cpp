@@ -39,6 +39,8 @@
 
 #include <vector>
 #include <unordered_map>
+#include <mutex>
+#include <algorithm>
 
 struct _port_cache {
      uint32_t front_panel_port;
@@ -52,6 +54,24 @@ static NasPhyPortMap _phy_port;
 
 #define MAX_HWPORT_PER_PORT 10
 
+/*
+ * Per-port descriptor read from NDI once, when the port is first seen or when
+ * NDI reports it added, so that physical port queries need no SDK calls.
+ */
+struct _port_desc {
+    uint32_t hwport;
+    bool hwport_valid;
+    std::vector<uint32_t> hwport_list;
+    std::vector<BASE_IF_SPEED_t> supported_speeds;
+};
+
+static std::mutex _port_desc_mtx;
+static bool _port_desc_populated = false;
+/* (npu << 32 | port) -> descriptor */
+static std::unordered_map<uint64_t, _port_desc> _port_desc_tbl;
+/* hwport -> (npu, port) */
+static std::unordered_map<uint32_t, ndi_port_t> _hwport_tbl;
+
 static  cps_api_return_code_t nas_fc_to_eth_speed(BASE_IF_SPEED_t speed, size_t hwp_count, BASE_IF_SPEED_t *npu_speed) {
     switch (speed) {
         case BASE_IF_SPEED_8GFC:
@@ -91,6 +111,97 @@ static bool get_hw_port(npu_id_t npu, port_t port, uint32_t& hwport) {
     return ndi_hwport_list_get(npu, port, &hwport) == STD_ERR_OK;
 }
 
+static inline uint64_t _port_desc_key(npu_id_t npu, port_t port) {
+    return (((uint64_t)npu) << 32) | port;
+}
+
+static void _port_desc_erase_locked(npu_id_t npu, port_t port) {
+    auto it = _port_desc_tbl.find(_port_desc_key(npu, port));
+    if (it == _port_desc_tbl.end()) return;
+
+    if (it->second.hwport_valid) {
+        auto hw_it = _hwport_tbl.find(it->second.hwport);
+        if (hw_it != _hwport_tbl.end() && hw_it->second.npu_id == npu &&
+            hw_it->second.npu_port == port) {
+            _hwport_tbl.erase(hw_it);
+        }
+    }
+    _port_desc_tbl.erase(it);
+}
+
+/* Read the port descriptor from NDI and (re)place it in the cache. Skips invalid and cpu ports */
+static _port_desc *_port_desc_load_locked(npu_id_t npu, port_t port) {
+    _port_desc_erase_locked(npu, port);
+
+    if (!ndi_port_is_valid(npu, port) || _is_cpu_port(npu, port)) {
+        return nullptr;
+    }
+
+    _port_desc desc;
+    desc.hwport_valid = get_hw_port(npu, port, desc.hwport);
+
+    uint32_t hwport_list[MAX_HWPORT_PER_PORT] = {0};
+    size_t count = MAX_HWPORT_PER_PORT;
+    if (ndi_hwport_list_get_list(npu, port, hwport_list, &count) == STD_ERR_OK) {
+        desc.hwport_list.assign(hwport_list, hwport_list + count);
+    }
+
+    size_t speed_count = NDI_PORT_SUPPORTED_SPEED_MAX;
+    BASE_IF_SPEED_t speed_list[NDI_PORT_SUPPORTED_SPEED_MAX];
+    if (ndi_port_supported_speed_get(npu, port, &speed_count, speed_list) == STD_ERR_OK) {
+        desc.supported_speeds.assign(speed_list, speed_list + speed_count);
+    }
+
+    if (desc.hwport_valid) {
+        ndi_port_t ndi_port;
+        ndi_port.npu_id = npu;
+        ndi_port.npu_port = port;
+        _hwport_tbl[desc.hwport] = ndi_port;
+    }
+    auto &entry = _port_desc_tbl[_port_desc_key(npu, port)];
+    entry = std::move(desc);
+    return &entry;
+}
+
+static _port_desc *_port_desc_get_locked(npu_id_t npu, port_t port) {
+    auto it = _port_desc_tbl.find(_port_desc_key(npu, port));
+    if (it != _port_desc_tbl.end()) return &it->second;
+    if (_port_desc_populated) return nullptr;
+    return _port_desc_load_locked(npu, port);
+}
+
+/* Walk all NPU ports once; afterwards the cache is kept current by port add/delete events */
+static void _port_desc_populate_locked(void) {
+    if (_port_desc_populated) return;
+
+    npu_id_t npu_max = (npu_id_t)nas_switch_get_max_npus();
+    for (npu_id_t npu = 0; npu < npu_max; ++npu) {
+        unsigned int intf_max_ports = ndi_max_npu_port_get(npu);
+        for (port_t port = 0; port < intf_max_ports; ++port) {
+            if (_port_desc_tbl.find(_port_desc_key(npu, port)) == _port_desc_tbl.end()) {
+                _port_desc_load_locked(npu, port);
+            }
+        }
+    }
+    _port_desc_populated = true;
+}
+
+static bool _port_desc_copy(npu_id_t npu, port_t port, _port_desc &desc) {
+    std::lock_guard<std::mutex> lock(_port_desc_mtx);
+    _port_desc *cached = _port_desc_get_locked(npu, port);
+    if (cached == nullptr) return false;
+    desc = *cached;
+    return true;
+}
+
+static bool get_cached_hw_port(npu_id_t npu, port_t port, uint32_t& hwport) {
+    std::lock_guard<std::mutex> lock(_port_desc_mtx);
+    _port_desc *cached = _port_desc_get_locked(npu, port);
+    if (cached == nullptr || !cached->hwport_valid) return false;
+    hwport = cached->hwport;
+    return true;
+}
+
 static void init_phy_port_obj(npu_id_t npu, port_t port, cps_api_object_t obj) {
     cps_api_key_from_attr_with_qual(cps_api_object_key(obj),
             BASE_IF_PHY_PHYSICAL_OBJ,cps_api_qualifier_TARGET);
@@ -100,9 +211,7 @@ static void init_phy_port_obj(npu_id_t npu, port_t port, cps_api_object_t obj) {
 }
 
 static void _if_fill_in_supported_speeds_attrs(npu_id_t npu, port_t port,
-        cps_api_object_t obj) {
-    size_t speed_count = NDI_PORT_SUPPORTED_SPEED_MAX;
-    BASE_IF_SPEED_t speed_list[NDI_PORT_SUPPORTED_SPEED_MAX];
+        const _port_desc &desc, cps_api_object_t obj) {
     cps_api_object_attr_t _phy_mode_attr = cps_api_object_attr_get(obj, BASE_IF_PHY_PHYSICAL_PHY_MODE);
     BASE_IF_PHY_MODE_TYPE_t phy_mode = BASE_IF_PHY_MODE_TYPE_ETHERNET;
 
@@ -117,18 +226,15 @@ static void _if_fill_in_supported_speeds_attrs(npu_id_t npu, port_t port,
         return;
     } 
     
-    if (ndi_port_supported_speed_get(npu,port,&speed_count, speed_list) == STD_ERR_OK) {
-        size_t mx = speed_count;
-        for (size_t ix =0;ix < mx; ix++) {
-            cps_api_object_attr_add_u32(obj,BASE_IF_PHY_PHYSICAL_SUPPORTED_SPEED, speed_list[ix]);
-        }
+    for (auto speed : desc.supported_speeds) {
+        cps_api_object_attr_add_u32(obj,BASE_IF_PHY_PHYSICAL_SUPPORTED_SPEED, speed);
     }
 }
 
 static _port_cache* get_phy_port_cache(npu_id_t npu, uint_t port)
 {
     uint32_t hwport;
-    if (!get_hw_port(npu, port, hwport)) {
+    if (!get_cached_hw_port(npu, port, hwport)) {
         return nullptr;
     }
     auto it = _phy_port.find(hwport);
@@ -175,21 +281,20 @@ static void make_phy_port_details(npu_id_t npu, port_t port, cps_api_object_t ob
         return;
     }
 
-    uint32_t hwport;
-    if (get_hw_port(npu,port,hwport)) {
-        cps_api_object_attr_add_u32(obj,BASE_IF_PHY_PHYSICAL_HARDWARE_PORT_ID,hwport);
+    _port_desc desc;
+    if (!_port_desc_copy(npu, port, desc)) {
+        return;
     }
 
-    uint32_t hwport_list[MAX_HWPORT_PER_PORT] = {0};
-    size_t count = MAX_HWPORT_PER_PORT;
-    if (ndi_hwport_list_get_list(npu, port, hwport_list, &count) == STD_ERR_OK) {
-        for (size_t idx = 0; idx < count; idx ++) {
-            cps_api_object_attr_add_u32(obj, BASE_IF_PHY_PHYSICAL_HARDWARE_PORT_LIST,
-                                        hwport_list[idx]);
-        }
+    if (desc.hwport_valid) {
+        cps_api_object_attr_add_u32(obj,BASE_IF_PHY_PHYSICAL_HARDWARE_PORT_ID,desc.hwport);
+    }
+
+    for (auto hwport : desc.hwport_list) {
+        cps_api_object_attr_add_u32(obj, BASE_IF_PHY_PHYSICAL_HARDWARE_PORT_LIST, hwport);
     }
 
-    _if_fill_in_supported_speeds_attrs(npu,port,obj);
+    _if_fill_in_supported_speeds_attrs(npu,port,desc,obj);
 
     auto phy_port = get_phy_port_cache(npu, port);
     if(phy_port != nullptr) {
@@ -206,37 +311,40 @@ static cps_api_return_code_t _phy_int_get (void * context, cps_api_get_params_t
 
     cps_api_object_t filt = cps_api_object_list_get(param->filters,key_ix);
 
-    npu_id_t npu = 0;
-    npu_id_t npu_max = (npu_id_t)nas_switch_get_max_npus();
-
     cps_api_object_attr_t _npu = cps_api_get_key_data(filt,BASE_IF_PHY_PHYSICAL_NPU_ID);
     cps_api_object_attr_t _port = cps_api_get_key_data(filt,BASE_IF_PHY_PHYSICAL_PORT_ID);
     cps_api_object_attr_t _hw_port = cps_api_get_key_data(filt,BASE_IF_PHY_PHYSICAL_HARDWARE_PORT_ID);
 
-    for ( npu = 0; npu<  npu_max ; ++npu){
-        if (_npu!=NULL && cps_api_object_attr_data_u32(_npu)!=(uint32_t)npu) continue;
+    std::vector<ndi_port_t> ports;
+    {
+        std::lock_guard<std::mutex> lock(_port_desc_mtx);
+        _port_desc_populate_locked();
 
-        unsigned int intf_max_ports = ndi_max_npu_port_get(npu);
-        for (port_t port = 0; port < intf_max_ports ; ++port ) {
-            if (_port!=NULL && cps_api_object_attr_data_u32(_port)!=port) continue;
-
-            if (_hw_port!=NULL) {
-                uint32_t hwport;
-                if (get_hw_port(npu,port,hwport)) {
-                    if (cps_api_object_attr_data_u32(_hw_port)!=hwport) continue;
-                }
+        if (_hw_port != NULL) {
+            auto it = _hwport_tbl.find(cps_api_object_attr_data_u32(_hw_port));
+            if (it != _hwport_tbl.end()) ports.push_back(it->second);
+        } else {
+            ports.reserve(_port_desc_tbl.size());
+            for (auto &entry : _port_desc_tbl) {
+                ndi_port_t ndi_port;
+                ndi_port.npu_id = (npu_id_t)(entry.first >> 32);
+                ndi_port.npu_port = (npu_port_t)(entry.first & 0xffffffff);
+                ports.push_back(ndi_port);
             }
+            std::sort(ports.begin(), ports.end(), [](const ndi_port_t &a, const ndi_port_t &b) {
+                return (a.npu_id != b.npu_id) ? (a.npu_id < b.npu_id) : (a.npu_port < b.npu_port);
+            });
+        }
+    }
 
-            // skip invalid port or cpu port
-            if (!ndi_port_is_valid(npu, port) || _is_cpu_port(npu, port)) {
-                continue;
-            }
+    for (auto &ndi_port : ports) {
+        if (_npu!=NULL && cps_api_object_attr_data_u32(_npu)!=(uint32_t)ndi_port.npu_id) continue;
+        if (_port!=NULL && cps_api_object_attr_data_u32(_port)!=ndi_port.npu_port) continue;
 
-            cps_api_object_t o = cps_api_object_list_create_obj_and_append(param->list);
-            if (o==NULL) return cps_api_ret_code_ERR;
+        cps_api_object_t o = cps_api_object_list_create_obj_and_append(param->list);
+        if (o==NULL) return cps_api_ret_code_ERR;
 
-            make_phy_port_details(npu,port,o);
-        }
+        make_phy_port_details(ndi_port.npu_id,ndi_port.npu_port,o);
     }
     return cps_api_ret_code_OK;
 }
@@ -339,6 +447,11 @@ static cps_api_return_code_t _phy_create(cps_api_object_t cur, cps_api_object_t
 
     cps_api_object_attr_add_u32(cur, BASE_IF_PHY_PHYSICAL_PORT_ID, phy_port_id);
 
+    {
+        std::lock_guard<std::mutex> lock(_port_desc_mtx);
+        _port_desc_load_locked(npu_id, phy_port_id);
+    }
+
     if (phy_mode == BASE_IF_PHY_MODE_TYPE_FC) {
 
         if (nas_cps_create_fc_port(npu_id, phy_port_id, speed, hw_ports.data(), hw_ports.size()) != cps_api_ret_code_OK) {
@@ -348,7 +461,7 @@ static cps_api_return_code_t _phy_create(cps_api_object_t cur, cps_api_object_t
     }
 
     uint32_t hwport;
-    if (!get_hw_port(npu_id, phy_port_id, hwport)) {
+    if (!get_cached_hw_port(npu_id, phy_port_id, hwport)) {
         EV_LOGGING(INTERFACE, ERR, "NAS-PHY-CREATE", "Failed to get hw port for port %d",
                    phy_port_id);
         return cps_api_ret_code_ERR;
@@ -387,7 +500,7 @@ static cps_api_return_code_t _phy_delete(cps_api_object_t cur, cps_api_object_t
     npu_port_t port_id = cps_api_object_attr_data_u32(port_attr);
 
     uint32_t hwport;
-    if (!get_hw_port(npu_id, port_id, hwport)) {
+    if (!get_cached_hw_port(npu_id, port_id, hwport)) {
         EV_LOGGING(INTERFACE, ERR, "NAS-PHY-DELETE", "Failed to get hw port for port %d",
                    port_id);
         return cps_api_ret_code_ERR;
@@ -414,6 +527,11 @@ static cps_api_return_code_t _phy_delete(cps_api_object_t cur, cps_api_object_t
         _phy_port.erase(it);
     }
 
+    {
+        std::lock_guard<std::mutex> lock(_port_desc_mtx);
+        _port_desc_erase_locked(npu_id, port_id);
+    }
+
     return cps_api_ret_code_OK;
 }
 
@@ -444,6 +562,15 @@ static void _ndi_port_event_update_ (ndi_port_t  *ndi_port, ndi_port_event_t eve
 
     if (!(event == ndi_port_ADD || event==ndi_port_DELETE)) return ;
 
+    {
+        std::lock_guard<std::mutex> lock(_port_desc_mtx);
+        if (event == ndi_port_ADD) {
+            _port_desc_load_locked(ndi_port->npu_id, ndi_port->npu_port);
+        } else {
+            _port_desc_erase_locked(ndi_port->npu_id, ndi_port->npu_port);
+        }
+    }
+
     cps_api_object_set_type_operation(cps_api_object_key(og.get()),event == ndi_port_ADD ?
         cps_api_oper_CREATE : cps_api_oper_DELETE );
 
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * nas_int_pkt_io_cfg.cpp
+ */
+
+#include "nas_int_pkt_io_cfg.h"
+#include "swp_util_tap.h"
+
+#include "event_log.h"
+#include "std_config_node.h"
+
+#include <mutex>
+#include <stdlib.h>
+#include <string.h>
+
+#define NAS_PKT_IO_MAX_READER_THREADS 16
+#define NAS_PKT_IO_MAX_TAP_BURST 256
+#define NAS_PKT_IO_MAX_TAP_RX_BACKLOG 4096
+#define NAS_PKT_IO_MAX_SFLOW_RING 65536
+#define NAS_PKT_IO_MAX_SFLOW_BATCH 256
+#define NAS_PKT_IO_MIN_SFLOW_HEADER_LEN 64
+
+static nas_pkt_io_cfg_t _pkt_io_cfg = {
+    1,  /* tap_reader_threads */
+    1,  /* tap_queues */
+    10, /* tap_burst */
+    64, /* tap_rx_backlog */
+    1024, /* sflow_ring */
+    32, /* sflow_batch */
+    0,  /* sflow_header_len, whole packet */
+};
+
+static size_t _cfg_attr_get_num(std_config_node_t node, const char *attr,
+                                size_t min, size_t max, size_t def)
+{
+    const char *val = std_config_attr_get(node, attr);
+    if (val == NULL) return def;
+
+    size_t num = strtoul(val, NULL, 0);
+    if (num < min || num > max) {
+        EV_LOGGING(NAS_PKT_IO, ERR, "PKT-IO-CFG", "Invalid %s value %s, using %lu",
+                   attr, val, def);
+        return def;
+    }
+    return num;
+}
+
+static void _pkt_io_cfg_load(void)
+{
+    std_config_hdl_t _hdl = std_config_load(NAS_PKT_IO_CFG_FILE);
+    if (_hdl == NULL) {
+        EV_LOGGING(NAS_PKT_IO, INFO, "PKT-IO-CFG", "No packet I/O config file, using defaults");
+        return;
+    }
+    std_config_node_t _node = std_config_get_root(_hdl);
+    if (_node == NULL) {
+        std_config_unload(_hdl);
+        return;
+    }
+    for (_node = std_config_get_child(_node); _node != NULL ; _node = std_config_next_node(_node)) {
+        const char *name = std_config_name_get(_node);
+        if (name == NULL) continue;
+
+        if (strcmp(name, "tap-reader") == 0) {
+            _pkt_io_cfg.tap_reader_threads = _cfg_attr_get_num(_node, "threads", 1,
+                    NAS_PKT_IO_MAX_READER_THREADS, _pkt_io_cfg.tap_reader_threads);
+            _pkt_io_cfg.tap_queues = _cfg_attr_get_num(_node, "queues", 1,
+                    SWP_UTIL_TAP_QUEUE_LEN_MAX, _pkt_io_cfg.tap_queues);
+            _pkt_io_cfg.tap_burst = _cfg_attr_get_num(_node, "burst", 1,
+                    NAS_PKT_IO_MAX_TAP_BURST, _pkt_io_cfg.tap_burst);
+        } else if (strcmp(name, "tap-writer") == 0) {
+            _pkt_io_cfg.tap_rx_backlog = _cfg_attr_get_num(_node, "backlog", 0,
+                    NAS_PKT_IO_MAX_TAP_RX_BACKLOG, _pkt_io_cfg.tap_rx_backlog);
+        } else if (strcmp(name, "sflow-export") == 0) {
+            _pkt_io_cfg.sflow_ring = _cfg_attr_get_num(_node, "ring", 1,
+                    NAS_PKT_IO_MAX_SFLOW_RING, _pkt_io_cfg.sflow_ring);
+            _pkt_io_cfg.sflow_batch = _cfg_attr_get_num(_node, "batch", 1,
+                    NAS_PKT_IO_MAX_SFLOW_BATCH, _pkt_io_cfg.sflow_batch);
+            size_t hdr_len = _cfg_attr_get_num(_node, "header-len", 0,
+                    NAS_PKT_IO_MAX_SFLOW_HEADER_LEN, _pkt_io_cfg.sflow_header_len);
+            /* 0 exports the whole packet */
+            if (hdr_len != 0 && hdr_len < NAS_PKT_IO_MIN_SFLOW_HEADER_LEN) {
+                EV_LOGGING(NAS_PKT_IO, ERR, "PKT-IO-CFG", "Invalid header-len value %lu, using %lu",
+                           hdr_len, _pkt_io_cfg.sflow_header_len);
+                hdr_len = _pkt_io_cfg.sflow_header_len;
+            }
+            _pkt_io_cfg.sflow_header_len = hdr_len;
+        }
+    }
+    std_config_unload(_hdl);
+
+    EV_LOGGING(NAS_PKT_IO, INFO, "PKT-IO-CFG", "TAP readers %lu, queues per TAP %lu, burst %lu, "
+               "rx backlog %lu", _pkt_io_cfg.tap_reader_threads, _pkt_io_cfg.tap_queues,
+               _pkt_io_cfg.tap_burst, _pkt_io_cfg.tap_rx_backlog);
+    EV_LOGGING(NAS_PKT_IO, INFO, "PKT-IO-CFG", "sFlow ring %lu, batch %lu, header len %lu",
+               _pkt_io_cfg.sflow_ring, _pkt_io_cfg.sflow_batch, _pkt_io_cfg.sflow_header_len);
+}
+
+const nas_pkt_io_cfg_t * nas_pkt_io_cfg_get(void)
+{
+    static std::once_flag _loaded;
+    std::call_once(_loaded, _pkt_io_cfg_load);
+    return &_pkt_io_cfg;
+}
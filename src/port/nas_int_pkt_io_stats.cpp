@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * nas_int_pkt_io_stats.cpp
+ */
+
+#include "nas_int_pkt_io_stats.h"
+
+#include "event_log.h"
+
+#include <mutex>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define NAS_PKT_IO_STATS_CACHE_LINE 64
+
+/* Counters of one thread. Only the owner thread writes them; single copy
+ * atomic stores let the reader add them up at any time.
+ */
+typedef struct _nas_pkt_io_stats_blk_t {
+    nas_pkt_io_stats_t stats;
+    bool trap_used[NAS_PKT_IO_STATS_MAX_TRAPS];
+} nas_pkt_io_stats_blk_t;
+
+static std::mutex _stats_mtx;
+static std::vector<nas_pkt_io_stats_blk_t*> _stats_blks;
+static nas_pkt_io_stats_t _stats_base;    // totals at the last clear
+static thread_local nas_pkt_io_stats_blk_t *_stats_blk = nullptr;
+
+static nas_pkt_io_stats_blk_t * _stats_blk_get()
+{
+    if (_stats_blk != nullptr) return _stats_blk;
+
+    void *mem = nullptr;
+    if (posix_memalign(&mem, NAS_PKT_IO_STATS_CACHE_LINE, sizeof(nas_pkt_io_stats_blk_t)) != 0) {
+        EV_LOGGING(NAS_PKT_IO, ERR, "PKT-IO-STATS", "Failed to allocate counter block");
+        return nullptr;
+    }
+    memset(mem, 0, sizeof(nas_pkt_io_stats_blk_t));
+
+    std::lock_guard<std::mutex> l(_stats_mtx);
+    //Blocks stay around after the thread exits so its counts are kept
+    _stats_blk = (nas_pkt_io_stats_blk_t *) mem;
+    _stats_blks.push_back(_stats_blk);
+    return _stats_blk;
+}
+
+static inline void _stats_add(uint64_t *cnt, uint64_t val)
+{
+    __atomic_store_n(cnt, __atomic_load_n(cnt, __ATOMIC_RELAXED) + val, __ATOMIC_RELAXED);
+}
+
+static inline uint64_t _stats_read(const uint64_t *cnt)
+{
+    return __atomic_load_n(cnt, __ATOMIC_RELAXED);
+}
+
+/* subtract the value at the last clear, never going below 0 */
+static inline void _stats_sub(uint64_t *cnt, uint64_t base)
+{
+    *cnt = (*cnt > base) ? (*cnt - base) : 0;
+}
+
+uint64_t nas_pkt_io_stats_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void nas_pkt_io_stats_inc(nas_pkt_io_cnt_t cnt, uint64_t val)
+{
+    nas_pkt_io_stats_blk_t *blk = _stats_blk_get();
+    if (blk == nullptr || cnt >= NAS_PKT_IO_CNT_MAX) return;
+    _stats_add(&blk->stats.cnt[cnt], val);
+}
+
+void nas_pkt_io_stats_drop(nas_pkt_io_drop_t reason, uint64_t val)
+{
+    nas_pkt_io_stats_blk_t *blk = _stats_blk_get();
+    if (blk == nullptr || reason >= NAS_PKT_IO_DROP_MAX) return;
+    _stats_add(&blk->stats.drop[reason], val);
+}
+
+static inline bool _stats_port_valid(npu_id_t npu, npu_port_t port)
+{
+    return (npu >= 0 && npu < NAS_PKT_IO_STATS_MAX_NPUS && port < NAS_PKT_IO_STATS_MAX_PORTS);
+}
+
+void nas_pkt_io_stats_port_rx(npu_id_t npu, npu_port_t port, uint64_t trap_id)
+{
+    nas_pkt_io_stats_blk_t *blk = _stats_blk_get();
+    if (blk == nullptr) return;
+
+    if (_stats_port_valid(npu, port)) _stats_add(&blk->stats.port_rx[npu][port], 1);
+
+    size_t ix = 0;
+    for (; ix < blk->stats.trap_count; ++ix) {
+        if (blk->stats.trap[ix].trap_id == trap_id) break;
+    }
+    if (ix == blk->stats.trap_count) {
+        if (ix == NAS_PKT_IO_STATS_MAX_TRAPS) {
+            _stats_add(&blk->stats.trap_other_rx, 1);
+            return;
+        }
+        //Publish the trap id before the slot can be seen by the reader
+        blk->stats.trap[ix].trap_id = trap_id;
+        __atomic_store_n(&blk->stats.trap_count, ix + 1, __ATOMIC_RELEASE);
+    }
+    _stats_add(&blk->stats.trap[ix].rx, 1);
+}
+
+void nas_pkt_io_stats_port_tx(npu_id_t npu, npu_port_t port, uint64_t val)
+{
+    nas_pkt_io_stats_blk_t *blk = _stats_blk_get();
+    if (blk == nullptr || !_stats_port_valid(npu, port)) return;
+    _stats_add(&blk->stats.port_tx[npu][port], val);
+}
+
+void nas_pkt_io_stats_latency(nas_pkt_io_lat_t lat, uint64_t start, uint64_t pkts)
+{
+    nas_pkt_io_stats_blk_t *blk = _stats_blk_get();
+    if (blk == nullptr || lat >= NAS_PKT_IO_LAT_MAX) return;
+
+    uint64_t us = (nas_pkt_io_stats_now() - start) / 1000;
+    size_t bucket = 0;
+    if (us != 0) {
+        bucket = 64 - __builtin_clzll(us);
+        if (bucket >= NAS_PKT_IO_LAT_BUCKETS) bucket = NAS_PKT_IO_LAT_BUCKETS - 1;
+    }
+    _stats_add(&blk->stats.lat[lat][bucket], pkts);
+}
+
+static void _stats_trap_add(nas_pkt_io_stats_t *out, uint64_t trap_id, uint64_t rx)
+{
+    for (size_t ix = 0; ix < out->trap_count; ++ix) {
+        if (out->trap[ix].trap_id == trap_id) {
+            out->trap[ix].rx += rx;
+            return;
+        }
+    }
+    if (out->trap_count == NAS_PKT_IO_STATS_MAX_TRAPS) {
+        out->trap_other_rx += rx;
+        return;
+    }
+    out->trap[out->trap_count].trap_id = trap_id;
+    out->trap[out->trap_count++].rx = rx;
+}
+
+/* called with _stats_mtx held */
+static void _stats_total(nas_pkt_io_stats_t *out)
+{
+    memset(out, 0, sizeof(*out));
+
+    for (auto blk : _stats_blks) {
+        const nas_pkt_io_stats_t& s = blk->stats;
+        for (size_t ix = 0; ix < NAS_PKT_IO_CNT_MAX; ++ix) out->cnt[ix] += _stats_read(&s.cnt[ix]);
+        for (size_t ix = 0; ix < NAS_PKT_IO_DROP_MAX; ++ix) out->drop[ix] += _stats_read(&s.drop[ix]);
+        for (size_t npu = 0; npu < NAS_PKT_IO_STATS_MAX_NPUS; ++npu) {
+            for (size_t ix = 0; ix < NAS_PKT_IO_STATS_MAX_PORTS; ++ix) {
+                out->port_rx[npu][ix] += _stats_read(&s.port_rx[npu][ix]);
+                out->port_tx[npu][ix] += _stats_read(&s.port_tx[npu][ix]);
+            }
+        }
+        for (size_t lat = 0; lat < NAS_PKT_IO_LAT_MAX; ++lat) {
+            for (size_t ix = 0; ix < NAS_PKT_IO_LAT_BUCKETS; ++ix) {
+                out->lat[lat][ix] += _stats_read(&s.lat[lat][ix]);
+            }
+        }
+        size_t traps = __atomic_load_n(&s.trap_count, __ATOMIC_ACQUIRE);
+        for (size_t ix = 0; ix < traps; ++ix) {
+            _stats_trap_add(out, s.trap[ix].trap_id, _stats_read(&s.trap[ix].rx));
+        }
+        out->trap_other_rx += _stats_read(&s.trap_other_rx);
+    }
+}
+
+void nas_pkt_io_stats_get(nas_pkt_io_stats_t *stats)
+{
+    std::lock_guard<std::mutex> l(_stats_mtx);
+
+    _stats_total(stats);
+
+    const nas_pkt_io_stats_t& base = _stats_base;
+    for (size_t ix = 0; ix < NAS_PKT_IO_CNT_MAX; ++ix) _stats_sub(&stats->cnt[ix], base.cnt[ix]);
+    for (size_t ix = 0; ix < NAS_PKT_IO_DROP_MAX; ++ix) _stats_sub(&stats->drop[ix], base.drop[ix]);
+    for (size_t npu = 0; npu < NAS_PKT_IO_STATS_MAX_NPUS; ++npu) {
+        for (size_t ix = 0; ix < NAS_PKT_IO_STATS_MAX_PORTS; ++ix) {
+            _stats_sub(&stats->port_rx[npu][ix], base.port_rx[npu][ix]);
+            _stats_sub(&stats->port_tx[npu][ix], base.port_tx[npu][ix]);
+        }
+    }
+    for (size_t lat = 0; lat < NAS_PKT_IO_LAT_MAX; ++lat) {
+        for (size_t ix = 0; ix < NAS_PKT_IO_LAT_BUCKETS; ++ix) {
+            _stats_sub(&stats->lat[lat][ix], base.lat[lat][ix]);
+        }
+    }
+    for (size_t ix = 0; ix < stats->trap_count; ++ix) {
+        for (size_t b_ix = 0; b_ix < base.trap_count; ++b_ix) {
+            if (base.trap[b_ix].trap_id == stats->trap[ix].trap_id) {
+                _stats_sub(&stats->trap[ix].rx, base.trap[b_ix].rx);
+                break;
+            }
+        }
+    }
+    //A trap id can move between its own slot and other from one total to the next
+    _stats_sub(&stats->trap_other_rx, base.trap_other_rx);
+}
+
+void nas_pkt_io_stats_clear(void)
+{
+    std::lock_guard<std::mutex> l(_stats_mtx);
+    _stats_total(&_stats_base);
+}
+
+void nas_pkt_io_stats_clear_cnt(nas_pkt_io_cnt_t cnt)
+{
+    if (cnt >= NAS_PKT_IO_CNT_MAX) return;
+
+    std::lock_guard<std::mutex> l(_stats_mtx);
+    nas_pkt_io_stats_t total;
+    _stats_total(&total);
+    _stats_base.cnt[cnt] = total.cnt[cnt];
+}
+
+void nas_pkt_io_stats_clear_drop(nas_pkt_io_drop_t reason)
+{
+    if (reason >= NAS_PKT_IO_DROP_MAX) return;
+
+    std::lock_guard<std::mutex> l(_stats_mtx);
+    nas_pkt_io_stats_t total;
+    _stats_total(&total);
+    _stats_base.drop[reason] = total.drop[reason];
+}
@@ -31,6 +31,8 @@
 #include "dell-base-if-phy.h"
 #include "nas_int_port.h"
 #include "nas_int_utils.h"
+#include "nas_int_pkt_io_cfg.h"
+#include "nas_int_pkt_io_stats.h"
 
 #include "swp_util_tap.h"
 
@@ -42,6 +44,7 @@
 #include "std_time_tools.h"
 #include "std_ip_utils.h"
 #include "std_mac_utils.h"
+#include "std_utils.h"
 
 #include <vector>
 #include <stdio.h>
@@ -51,13 +54,16 @@
 #include <event2/event.h>
 #include <event2/thread.h>
 #include <signal.h>
+#include <pthread.h>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 
 
 
-#define MAX_QUEUE          1
-/* num packets to read on fd event */
-#define NAS_PKT_COUNT_TO_READ 10
 /* num packets to read from nflog fd */
 #define NAS_NFLOG_PKT_COUNT_TO_READ 1
 /* invalid port id to indicate virtual interface */
@@ -65,7 +71,30 @@
 
 //Lock for a interface structures
 static std_rw_lock_t ports_lock = PTHREAD_RWLOCK_INITIALIZER;
-static std_mutex_lock_create_static_init_fast(tap_fd_lock);
+//Readers share the tap fd lock, only closing the tap fds takes it exclusively
+static std_rw_lock_t tap_fd_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+/* packets sent to a tap by the NPU RX path */
+typedef struct _nas_tap_rx_stats_t {
+    uint64_t written;       // written to the tap
+    uint64_t backlogged;    // held in the backlog because the tap was busy
+    uint64_t dropped_full;  // dropped because the backlog was full
+    uint64_t dropped_err;   // dropped on a write error
+} nas_tap_rx_stats_t;
+
+/* RX writer of a tap queue. The NDI RX path writes straight from the NDI
+ * buffer with a non-blocking write; packets the kernel can't take right away
+ * are copied to a bounded backlog that is flushed by the reader serving the
+ * queue once the fd becomes writable.
+ */
+typedef struct _nas_tap_wr_queue_t {
+    int fd = SWP_UTIL_INV_FD;
+    struct event *wr_ev = nullptr;
+    std::mutex mtx;
+    std::deque<std::vector<uint8_t>> backlog;
+    bool pending = false;               // wr_ev added
+    nas_tap_rx_stats_t *stats = nullptr;
+} nas_tap_wr_queue_t;
 
 class CNasPortDetails {
 private:
@@ -74,6 +103,12 @@ private:
     port_t _port = 0;
     bool _mapped = false;
     swp_util_tap_descr _dscr=nullptr;
+    hal_ifindex_t _ifindex = -1;  // captured once the tap is created
+    std::vector<nas_tap_wr_queue_t*> _wr_queues;  // one per tap queue while link is up
+    nas_tap_rx_stats_t _rx_stats = {0, 0, 0, 0};
+
+    void open_wr_queues();
+    void close_wr_queues();
     IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_t _link =
             IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_DOWN;
 public:
@@ -102,6 +137,11 @@ public:
     inline npu_id_t npu() const { return _npu; }
     inline port_t port() const { return _port; }
     inline swp_util_tap_descr tap() const { return _dscr; }
+    inline size_t wr_queue_count() const { return _wr_queues.size(); }
+    inline nas_tap_wr_queue_t *wr_queue(size_t queue) const {
+        return (queue < _wr_queues.size()) ? _wr_queues[queue] : nullptr;
+    }
+    inline const nas_tap_rx_stats_t& rx_stats() const { return _rx_stats; }
 
     virtual ~CNasPortDetails();
 };
@@ -120,12 +160,21 @@ private:
     CNasPortDetails* _dummy_port = nullptr;
     std::unordered_map<std::string, CNasPortDetails> port_name_info_map;
     std::vector<std::vector<CNasPortDetails*>> port_id_info_list;
+    /* flat [npu][port] ifindex table for the packet fast paths. Entries are
+     * written under ports_lock and read without any lock; 0 means no port.
+     */
+    size_t _npus = 0;
+    size_t _max_ports = 0;
+    std::unique_ptr<std::atomic<hal_ifindex_t>[]> _ifindex_tbl;
 public:
-    std::vector<CNasPortDetails*>& operator[](npu_id_t npu)
+    const std::vector<CNasPortDetails*>& operator[](npu_id_t npu) const
     {
         return port_id_info_list[npu];
     }
-    void resize(size_t npus) {port_id_info_list.resize(npus);}
+    void resize(size_t npus, size_t max_ports);
+    size_t npus() const { return _npus; }
+    void map(npu_id_t npu, port_t port, CNasPortDetails *details);
+    bool cached_ifindex(npu_id_t npu, port_t port, hal_ifindex_t *ifindex) const;
     void erase(std::string name) {port_name_info_map.erase(name);}
     CNasPortDetails* dummy_port() {return _dummy_port;}
     const CNasPortDetails& operator[](std::string name) const;
@@ -147,6 +196,39 @@ NasPortList::~NasPortList()
     }
 }
 
+void NasPortList::resize(size_t npus, size_t max_ports)
+{
+    port_id_info_list.resize(npus);
+    for (auto &ports : port_id_info_list) {
+        ports.assign(max_ports, _dummy_port);
+    }
+    _ifindex_tbl.reset(new std::atomic<hal_ifindex_t>[npus * max_ports]);
+    for (size_t ix = 0; ix < npus * max_ports; ++ix) {
+        _ifindex_tbl[ix].store(0, std::memory_order_relaxed);
+    }
+    _npus = npus;
+    _max_ports = max_ports;
+}
+
+void NasPortList::map(npu_id_t npu, port_t port, CNasPortDetails *details)
+{
+    port_id_info_list[npu][port] = details;
+
+    hal_ifindex_t ifindex = details->valid() ? details->ifindex() : 0;
+    _ifindex_tbl[npu * _max_ports + port].store(ifindex > 0 ? ifindex : 0,
+                                                std::memory_order_release);
+}
+
+bool NasPortList::cached_ifindex(npu_id_t npu, port_t port, hal_ifindex_t *ifindex) const
+{
+    if ((size_t)npu >= _npus || (size_t)port >= _max_ports) return false;
+
+    hal_ifindex_t val = _ifindex_tbl[npu * _max_ports + port].load(std::memory_order_acquire);
+    if (val == 0) return false;
+    *ifindex = val;
+    return true;
+}
+
 const CNasPortDetails& NasPortList::operator[](std::string name) const
 {
     auto iter = port_name_info_map.find(name);
@@ -161,10 +243,24 @@ static NasPortList& _ports = *new NasPortList();
 /* tap fd to event info details */
 typedef std::unordered_map<int,struct event *> _fd_to_event_info_map_t;
 
+/* tap reader thread; each reader runs its own event base and tx buffer */
+typedef struct _nas_vif_pkt_reader_t {
+    size_t id;
+    pthread_t thr;
+    struct event_base *evt_base;       // Pointer to reader event base
+    struct event *keepalive_ev;        // keeps the dispatch loop running with no taps
+    void *tx_buf;                      // Pointer to reader packet tx buffer
+    unsigned int tx_buf_len;           // packet tx buffer len
+    void *burst_buf;                   // ring of burst_len packet buffers of tx_buf_len each
+    hal_virt_pkt_t *burst;             // packets of the burst being read
+    size_t burst_len;                  // max packets read from a tap queue per event
+} nas_vif_pkt_reader_t;
+
 typedef struct _nas_vif_pkt_tx_t {
-    struct event_base *nas_evt_base;    // Pointer to event base
+    struct event_base *nas_evt_base;    // Pointer to event base of reader 0
     struct event *nas_signal_event;     // Pointer to our signal event
     hal_virt_pkt_transmit egress_tx_cb; // Pointer to packet tx callback function
+    hal_virt_pkt_transmit_burst egress_tx_burst_cb; // Pointer to packet burst tx callback function
     // Pointer to packet tx to ingress pipeline callback function
     hal_virt_pkt_transmit_to_ingress_pipeline tx_to_ingress_fun;
     hal_virt_pkt_transmit_to_ingress_pipeline_hybrid tx_to_ingress_hybrid_fun;
@@ -173,14 +269,14 @@ typedef struct _nas_vif_pkt_tx_t {
     struct event *nas_nflog_fd_ev;     // nflog fd event struct
     int nas_nflog_fd;                  // fd for packet copy thru nflog
     _fd_to_event_info_map_t _tap_fd_to_event_info_map; //fd to event base info
+    std::vector<nas_vif_pkt_reader_t> readers; // tap reader pool, reader 0 runs on caller thread
 } nas_vif_pkt_tx_t;
 
 nas_vif_pkt_tx_t g_vif_pkt_tx; //global virtual interface packet tx information
 
-static int     nas_nflog_pkts_tx_to_ingress_pipeline = 0;
-static int     nas_nflog_pkts_tx_to_ingress_pipeline_dropped = 0;
-static int     nas_nflog_pkts_tx_to_ingress_pipeline_hybrid = 0;
-static int     nas_nflog_pkts_tx_to_ingress_pipeline_hybrid_dropped = 0;
+/* reader owning the calling thread, set when the reader starts dispatching */
+static thread_local nas_vif_pkt_reader_t *_cur_reader = nullptr;
+
 uint8_t        dest_ipv4_from_last_pkt[4];
 static struct timespec ts_last_pkt_sent = {0,0};
 uint8_t        dest_ipv6_from_last_pkt[16];
@@ -238,25 +334,32 @@ t_std_error nas_del_fd_from_evt_info_map (int fd)
     return STD_ERR_OK;
 }
 
+/* Pick the reader that serves a tap queue. Queues of a port are spread over
+ * consecutive readers so a multi-queue tap is drained by several threads.
+ */
+static nas_vif_pkt_reader_t * tap_queue_reader (CNasPortDetails *nas_port, int queue, int fd) {
+    size_t key = nas_port->mapped() ? (size_t)nas_port->port() : (size_t)fd;
+    return &g_vif_pkt_tx.readers[(key + queue) % g_vif_pkt_tx.readers.size()];
+}
+
 /* this function is called when tap interface becomes oper up.
  * On oper up, add the tap interface fd's to event for read event.
  * Also add the fd to event base info to the mapping table.
  */
 static t_std_error tap_fd_register_with_evt (swp_util_tap_descr tap, CNasPortDetails *nas_port) {
-    fd_set fds;
     struct event *nas_fd_ev = NULL;     // fd event struct
 
-    FD_ZERO(&fds);
-
-    /* get the fd(s) for this tap interface */
-    swp_util_tap_fd_set_add(&tap, 1, &fds);
+    if (g_vif_pkt_tx.readers.empty()) {
+        EV_LOGGING(INTERFACE,ERR,"TAP-TX", "NAS Packet readers not running for interface (%s)",
+                   swp_util_tap_descr_get_name(tap));
+        return STD_ERR(INTERFACE,FAIL,0);
+    }
 
-    while (true) {
-        /* scan thru the fd(s) and add each fd to event */
-        int fd = swp_util_tap_fd_locate_from_set(tap, &fds);
-        if (fd < 0)
-            break;
-        FD_CLR(fd, &fds);
+    for (int queue = 0; queue < SWP_UTIL_TAP_QUEUE_LEN_MAX; ++queue) {
+        /* scan thru the fd(s) of each queue and add each fd to event */
+        int fd = swp_util_tap_descr_get_queue(tap, queue);
+        if (fd == SWP_UTIL_INV_FD)
+            continue;
 
         auto it = g_vif_pkt_tx._tap_fd_to_event_info_map.find(fd);
         if (it != g_vif_pkt_tx._tap_fd_to_event_info_map.end())
@@ -268,8 +371,9 @@ static t_std_error tap_fd_register_with_evt (swp_util_tap_descr tap, CNasPortDet
             continue;
         }
 
-        // Setup the events for this fd
-        nas_fd_ev = event_new(g_vif_pkt_tx.nas_evt_base, fd,
+        // Setup the events for this fd on the reader serving this queue
+        nas_vif_pkt_reader_t *reader = tap_queue_reader(nas_port, queue, fd);
+        nas_fd_ev = event_new(reader->evt_base, fd,
                               EV_READ | EV_PERSIST, process_packets, (void *)nas_port);
 
         if (!nas_fd_ev) {
@@ -336,7 +440,7 @@ static void tap_fd_close(swp_util_tap_descr tap) {
 
     //make sure tap_fd access to be protected before closing it.
     //make sure tap_fd_lock is not taken before calling any event lib api's.
-    std_mutex_simple_lock_guard l(&tap_fd_lock);
+    std_rw_lock_write_guard l(&tap_fd_lock);
     swp_util_close_fds(tap);
     return;
 }
@@ -399,13 +503,38 @@ static void tap_delete(swp_util_tap_descr tap) {
     swp_util_free_descrs(tap);
 }
 
+/* linux taps already set up by nas_int_port_tap_prepare */
+static std::mutex _tap_prepared_lock;
+static std::unordered_set<std::string> _tap_prepared;
+
+t_std_error nas_int_port_tap_prepare(const char *name) {
+    t_std_error rc = swp_util_tap_operation(name,SWP_UTIL_TYPE_TAP,true);
+    if (rc != STD_ERR_OK) {
+        EV_LOGGING(INTERFACE,ERR,"INTF-CREATE", "Failed to create linux interface %s",name);
+        return rc;
+    }
+    std::lock_guard<std::mutex> l(_tap_prepared_lock);
+    _tap_prepared.insert(name);
+    return STD_ERR_OK;
+}
+
+void nas_int_port_tap_prepare_clear(void) {
+    std::lock_guard<std::mutex> l(_tap_prepared_lock);
+    _tap_prepared.clear();
+}
+
+static bool tap_prepared(const char *name) {
+    std::lock_guard<std::mutex> l(_tap_prepared_lock);
+    return _tap_prepared.erase(name) != 0;
+}
+
 static swp_util_tap_descr tap_create(CNasPortDetails *npu, const char * name, uint_t queues) {
     swp_util_tap_descr tap = swp_util_alloc_descr();
     if (tap==nullptr) return tap;
 
     swp_util_tap_descr_init_wname(tap,name,NULL,NULL,NULL,NULL,queues);
 
-    if (swp_util_tap_operation(name,SWP_UTIL_TYPE_TAP,true)!=STD_ERR_OK) {
+    if (!tap_prepared(name) && swp_util_tap_operation(name,SWP_UTIL_TYPE_TAP,true)!=STD_ERR_OK) {
         EV_LOGGING(INTERFACE,ERR,"INTF-DEL", "Failed to create linux interface %s",name);
     }
     return tap;
@@ -423,30 +552,157 @@ bool CNasPortDetails::del() {
     tap_delete(_dscr);
 
     _dscr = nullptr;
+    _ifindex = -1;
     return true;
 }
 
 bool CNasPortDetails::create(const char *name) {
     if (_used) return true;
     _used = true;
-    _dscr = tap_create(this,name,MAX_QUEUE);
+    _dscr = tap_create(this,name,nas_pkt_io_cfg_get()->tap_queues);
+    if (_dscr != nullptr) _ifindex = swp_init_tap_ifindex(_dscr);
     return true;
 }
 
 void CNasPortDetails::set_link_state(IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_t state)  {
     if (_dscr == nullptr || _link == state) return;
     if (state == IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_UP) {
-        if (tap_link_up(_dscr, this)) _link=state;
+        if (tap_link_up(_dscr, this)) {
+            open_wr_queues();
+            _link=state;
+        }
     }
     if (state == IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_DOWN) {
+        //writers have to be gone before the tap fds are closed
+        close_wr_queues();
         tap_link_down(_dscr);
         _link = state;
     }
 }
 
+/* flush the backlog of a tap queue, called by the reader when the fd is writable */
+static void tap_wr_queue_drain (evutil_socket_t fd, short evt, void *arg)
+{
+    nas_tap_wr_queue_t *wq = (nas_tap_wr_queue_t *) arg;
+    std::lock_guard<std::mutex> l(wq->mtx);
+
+    while (!wq->backlog.empty()) {
+        const std::vector<uint8_t>& pkt = wq->backlog.front();
+        ssize_t n = write(fd, pkt.data(), pkt.size());
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+
+        if (n == (ssize_t)pkt.size()) {
+            __atomic_add_fetch(&wq->stats->written, 1, __ATOMIC_RELAXED);
+        } else {
+            __atomic_add_fetch(&wq->stats->dropped_err, 1, __ATOMIC_RELAXED);
+        }
+        wq->backlog.pop_front();
+    }
+
+    wq->pending = !wq->backlog.empty();
+    if (wq->pending) event_add(wq->wr_ev, NULL);
+}
+
+static t_std_error tap_wr_queue_send (nas_tap_wr_queue_t *wq, const void *data, unsigned int len)
+{
+    std::lock_guard<std::mutex> l(wq->mtx);
+
+    /* keep the packet order - only write directly when nothing is queued */
+    if (wq->backlog.empty()) {
+        ssize_t n = write(wq->fd, data, len);
+        if (n == (ssize_t)len) {
+            __atomic_add_fetch(&wq->stats->written, 1, __ATOMIC_RELAXED);
+            return STD_ERR_OK;
+        }
+        if (n >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            __atomic_add_fetch(&wq->stats->dropped_err, 1, __ATOMIC_RELAXED);
+            return STD_ERR(INTERFACE,FAIL,errno);
+        }
+    }
+
+    if (wq->backlog.size() >= nas_pkt_io_cfg_get()->tap_rx_backlog) {
+        __atomic_add_fetch(&wq->stats->dropped_full, 1, __ATOMIC_RELAXED);
+        return STD_ERR(INTERFACE,FAIL,EAGAIN);
+    }
+
+    const uint8_t *pkt = (const uint8_t *) data;
+    wq->backlog.emplace_back(pkt, pkt + len);
+    __atomic_add_fetch(&wq->stats->backlogged, 1, __ATOMIC_RELAXED);
+
+    if (!wq->pending) {
+        wq->pending = true;
+        event_add(wq->wr_ev, NULL);
+    }
+    return STD_ERR_OK;
+}
+
+/* called with ports_lock held for write once the tap fds are registered */
+void CNasPortDetails::open_wr_queues() {
+    for (int queue = 0; queue < SWP_UTIL_TAP_QUEUE_LEN_MAX; ++queue) {
+        int fd = swp_util_tap_descr_get_queue(_dscr, queue);
+        if (fd == SWP_UTIL_INV_FD) break;
+
+        nas_tap_wr_queue_t *wq = new nas_tap_wr_queue_t;
+        wq->fd = fd;
+        wq->stats = &_rx_stats;
+        wq->wr_ev = event_new(tap_queue_reader(this, queue, fd)->evt_base, fd, EV_WRITE,
+                              tap_wr_queue_drain, wq);
+        if (wq->wr_ev == nullptr) {
+            EV_LOGGING(INTERFACE,ERR,"TAP-RX", "NAS Packet write event create failed for interface "
+                       "(%s) fd (%d).", swp_util_tap_descr_get_name(_dscr), fd);
+            delete wq;
+            break;
+        }
+        _wr_queues.push_back(wq);
+    }
+}
+
+/* called with ports_lock held for write, before the tap fds are closed */
+void CNasPortDetails::close_wr_queues() {
+    for (auto wq : _wr_queues) {
+        //event_del waits for a running drain callback to complete
+        event_del(wq->wr_ev);
+        event_free(wq->wr_ev);
+        delete wq;
+    }
+    _wr_queues.clear();
+}
+
+/* Pick a tap queue from the flow of the packet (MAC addresses and, for IP,
+ * the IP addresses) so the packets of a flow are kept in order
+ */
+static size_t tap_rx_queue_select (const uint8_t *pkt, unsigned int len, size_t queues)
+{
+#define ETH_ADDRS_LEN   12
+#define ETH_HDR_LEN     14
+#define VLAN_TAG_LEN    4
+    if (queues <= 1 || len < ETH_HDR_LEN) return 0;
+
+    uint32_t hash = 2166136261u;
+    auto fnv = [&hash](const uint8_t *p, size_t n) {
+        for (size_t ix = 0; ix < n; ++ix) {
+            hash = (hash ^ p[ix]) * 16777619u;
+        }
+    };
+    fnv(pkt, ETH_ADDRS_LEN);
+
+    size_t l3 = ETH_HDR_LEN;
+    uint16_t ether_type = (pkt[ETH_ADDRS_LEN] << 8) | pkt[ETH_ADDRS_LEN + 1];
+    if (ether_type == 0x8100 && len >= ETH_HDR_LEN + VLAN_TAG_LEN) {
+        ether_type = (pkt[ETH_HDR_LEN + 2] << 8) | pkt[ETH_HDR_LEN + 3];
+        l3 += VLAN_TAG_LEN;
+    }
+    if (ether_type == 0x0800 && len >= l3 + 20) {
+        fnv(pkt + l3 + 12, 8);      // IPv4 source and destination
+    } else if (ether_type == 0x86dd && len >= l3 + 40) {
+        fnv(pkt + l3 + 8, 32);      // IPv6 source and destination
+    }
+    return hash % queues;
+}
+
 hal_ifindex_t CNasPortDetails::ifindex() const{
     if (_dscr==nullptr) return -1;
-    return swp_init_tap_ifindex(_dscr);
+    return _ifindex;
 }
 
 
@@ -474,7 +730,9 @@ void nas_evt_signal_cb (evutil_socket_t sig_num, short evt, void *arg)
 
     event_del (p_vif_pkt_tx->nas_signal_event);
     event_free (p_vif_pkt_tx->nas_signal_event);
-    event_base_loopbreak(p_vif_pkt_tx->nas_evt_base);
+    for (auto &reader : p_vif_pkt_tx->readers) {
+        event_base_loopbreak(reader.evt_base);
+    }
 }
 
 int nas_process_payload_and_form_NS_packet(uint8_t *pkt_buf, nas_nflog_params_t *p_nas_nflog_params,
@@ -710,7 +968,7 @@ void process_nflog_packets (evutil_socket_t fd, short evt, void *arg)
      */
     while (pkt_count < NAS_NFLOG_PKT_COUNT_TO_READ)
     {
-        pkt_len = read(fd, g_vif_pkt_tx.tx_buf, g_vif_pkt_tx.tx_buf_len);
+        pkt_len = read(fd, _cur_reader->tx_buf, _cur_reader->tx_buf_len);
 
         if (pkt_len <=0)
         {
@@ -722,13 +980,13 @@ void process_nflog_packets (evutil_socket_t fd, short evt, void *arg)
         nflog_params.out_ifindex = 0;
         nflog_params.payload_len = 0;
 
-        nas_os_nl_get_nflog_params ((uint8_t *) g_vif_pkt_tx.tx_buf,
+        nas_os_nl_get_nflog_params ((uint8_t *) _cur_reader->tx_buf,
                                     pkt_len, &nflog_params);
 
         if (!(nflog_params.payload_len))
         {
             /* skip, if payload length is not valid */
-            nas_nflog_pkts_tx_to_ingress_pipeline_dropped++;
+            nas_pkt_io_stats_drop(NAS_PKT_IO_DROP_NFLOG_NO_PAYLOAD, 1);
             continue;
         }
 
@@ -741,13 +999,13 @@ void process_nflog_packets (evutil_socket_t fd, short evt, void *arg)
         if ((dn_hal_get_interface_info(&intf_ctrl)) != STD_ERR_OK) {
             EV_LOGGING(INTERFACE,ERR,"TAP-TX", "Processing payload failed. Invalid interface %d. ifInfo get failed",
                        nflog_params.out_ifindex);
-            nas_nflog_pkts_tx_to_ingress_pipeline_dropped++;
+            nas_pkt_io_stats_drop(NAS_PKT_IO_DROP_NFLOG_NO_INTF, 1);
             continue;
         }
 
         nas_int_type_t int_type = intf_ctrl.int_type;
         nas_bridge_id_t bridge_id = intf_ctrl.bridge_id;
-        pkt_len = nas_process_payload_and_form_packet ((uint8_t *) g_vif_pkt_tx.tx_buf,
+        pkt_len = nas_process_payload_and_form_packet ((uint8_t *) _cur_reader->tx_buf,
                                                        &nflog_params, &intf_ctrl);
 
         /* send packet for transmission to ingress pipeline processing
@@ -755,18 +1013,18 @@ void process_nflog_packets (evutil_socket_t fd, short evt, void *arg)
          */
         if (pkt_len > 0) {
             if(int_type == nas_int_type_DOT1D_BRIDGE) {
-                nas_nflog_pkts_tx_to_ingress_pipeline_hybrid++;
-                g_vif_pkt_tx.tx_to_ingress_hybrid_fun (g_vif_pkt_tx.tx_buf,pkt_len,
+                nas_pkt_io_stats_inc(NAS_PKT_IO_CNT_NFLOG_TX_LOOKUP_HYBRID, 1);
+                g_vif_pkt_tx.tx_to_ingress_hybrid_fun (_cur_reader->tx_buf,pkt_len,
                                                        NDI_PACKET_TX_TYPE_PIPELINE_HYBRID_BRIDGE, bridge_id);
             } else {
-                nas_nflog_pkts_tx_to_ingress_pipeline++;
-                g_vif_pkt_tx.tx_to_ingress_fun (g_vif_pkt_tx.tx_buf,pkt_len);
+                nas_pkt_io_stats_inc(NAS_PKT_IO_CNT_NFLOG_TX_LOOKUP, 1);
+                g_vif_pkt_tx.tx_to_ingress_fun (_cur_reader->tx_buf,pkt_len);
             }
         } else if (pkt_len == 0) {
             if(int_type == nas_int_type_DOT1D_BRIDGE) {
-                nas_nflog_pkts_tx_to_ingress_pipeline_hybrid_dropped++;
+                nas_pkt_io_stats_drop(NAS_PKT_IO_DROP_NFLOG_FLOOD_HYBRID, 1);
             } else {
-                nas_nflog_pkts_tx_to_ingress_pipeline_dropped++;
+                nas_pkt_io_stats_drop(NAS_PKT_IO_DROP_NFLOG_FLOOD, 1);
             }
         }
     }
@@ -781,7 +1039,7 @@ void process_nflog_packets (evutil_socket_t fd, short evt, void *arg)
 void process_packets (evutil_socket_t fd, short evt, void *arg)
 {
     int pkt_len = 0;
-    int pkt_count = 0;
+    size_t pkt_count = 0;
     npu_id_t npu = 0;
     port_t port = 0;
 
@@ -798,40 +1056,155 @@ void process_packets (evutil_socket_t fd, short evt, void *arg)
     port  = details->port();
 
     swp_util_tap_descr tap = details->tap();
+    hal_virt_pkt_t *burst = _cur_reader->burst;
+    uint64_t start = nas_pkt_io_stats_now();
 
     /* event is received in level-triggered mode,
-     * so read data as required and w/o starving other ports
+     * so read data as required and w/o starving other ports.
+     * The packets are drained into the reader's burst ring and handed over together.
      */
-    while (pkt_count < NAS_PKT_COUNT_TO_READ)
     {
+        std_rw_lock_read_guard l(&tap_fd_lock);
+        if (swp_util_tap_is_fd_in_tap_fd_set(tap, fd) == false)
         {
-            std_mutex_simple_lock_guard l(&tap_fd_lock);
-            if (swp_util_tap_is_fd_in_tap_fd_set(tap, fd) == false)
+            EV_LOGGING(INTERFACE,ERR, "TAP-TX", "TAP fd closed already. "
+                    "npu:%d, port:%d, fd:%d",
+                    npu, port, fd);
+            return;
+        }
+
+        while (pkt_count < _cur_reader->burst_len)
+        {
+            pkt_len = read(fd, burst[pkt_count].data, _cur_reader->tx_buf_len);
+            if (pkt_len <=0)
             {
-                EV_LOGGING(INTERFACE,ERR, "TAP-TX", "TAP fd closed already. "
-                        "npu:%d, port:%d, fd:%d",
-                        npu, port, fd);
+                /* no more data to read */
                 break;
             }
+            burst[pkt_count++].len = pkt_len;
+        }
+    }
+    if (pkt_count == 0) return;
 
-            pkt_len = read(fd, g_vif_pkt_tx.tx_buf, g_vif_pkt_tx.tx_buf_len);
+    /* send packets for transmission to registered callback function with the reader's packet buffers */
+    if (g_vif_pkt_tx.egress_tx_burst_cb != NULL) {
+        g_vif_pkt_tx.egress_tx_burst_cb(npu,port,burst,pkt_count);
+    } else {
+        for (size_t ix = 0; ix < pkt_count; ++ix) {
+            g_vif_pkt_tx.egress_tx_cb(npu,port,burst[ix].data,burst[ix].len);
         }
-        if (pkt_len <=0)
-        {
-            /* no more data to read */
-            break;
+    }
+    nas_pkt_io_stats_latency(NAS_PKT_IO_LAT_TAP_TO_NDI, start, pkt_count);
+}
+
+
+static void nas_vif_reader_keepalive_cb (evutil_socket_t fd, short evt, void *arg)
+{
+    /* nothing to do, the timer only keeps the reader event loop from exiting */
+}
+
+/* initialize a tap reader; readers other than the first own their tx buffer */
+static t_std_error nas_vif_reader_init (nas_vif_pkt_reader_t *reader, size_t id,
+                                        void *buf, unsigned int len)
+{
+    memset(reader, 0, sizeof(*reader));
+    reader->id = id;
+    reader->tx_buf_len = len;
+    reader->tx_buf = (buf != NULL) ? buf : malloc(len);
+    reader->burst_len = nas_pkt_io_cfg_get()->tap_burst;
+    reader->burst_buf = malloc(reader->burst_len * len);
+    reader->burst = (hal_virt_pkt_t *) calloc(reader->burst_len, sizeof(hal_virt_pkt_t));
+    if (reader->tx_buf == NULL || reader->burst_buf == NULL || reader->burst == NULL) {
+        EV_LOGGING(INTERFACE,ERR,"TAP-TX", "NAS Packet reader %lu buffer allocation failed.", id);
+        return STD_ERR(INTERFACE,NOMEM,0);
+    }
+    for (size_t ix = 0; ix < reader->burst_len; ++ix) {
+        reader->burst[ix].data = (uint8_t *) reader->burst_buf + (ix * len);
+    }
+
+    reader->evt_base = event_base_new();
+    if (!reader->evt_base) {
+        EV_LOGGING(INTERFACE,ERR,"TAP-TX", "NAS Packet reader %lu event base initialization failed.", id);
+        return STD_ERR(INTERFACE,FAIL,0);
+    }
+
+    if (id == 0) return STD_ERR_OK;
+
+    /* events for tap interfaces are only added once ports are oper up, so a
+     * persistent timer keeps the dispatch loop alive until then
+     */
+    static const struct timeval keepalive_tv = {3600, 0};
+    reader->keepalive_ev = event_new(reader->evt_base, -1, EV_PERSIST,
+                                     nas_vif_reader_keepalive_cb, NULL);
+    if (!reader->keepalive_ev || event_add(reader->keepalive_ev, &keepalive_tv) < 0) {
+        EV_LOGGING(INTERFACE,ERR,"TAP-TX", "NAS Packet reader %lu event initialization failed.", id);
+        return STD_ERR(INTERFACE,FAIL,0);
+    }
+    return STD_ERR_OK;
+}
+
+/* release a reader whose thread was never started */
+static void nas_vif_reader_free (nas_vif_pkt_reader_t *reader)
+{
+    if (reader->keepalive_ev) event_free(reader->keepalive_ev);
+    if (reader->evt_base) event_base_free(reader->evt_base);
+    if (reader->id != 0) free(reader->tx_buf);
+    free(reader->burst_buf);
+    free(reader->burst);
+    memset(reader, 0, sizeof(*reader));
+}
+
+/* release the readers of a pool whose threads were never started */
+static void nas_vif_readers_free (std::vector<nas_vif_pkt_reader_t> &readers)
+{
+    for (auto &reader : readers) {
+        nas_vif_reader_free(&reader);
+    }
+    readers.clear();
+    g_vif_pkt_tx.nas_evt_base = NULL;
+}
+
+/* stop and join the reader threads once reader 0 stopped dispatching, then
+ * release the pool along with the tap events still registered with it
+ */
+static void nas_vif_readers_stop (void)
+{
+    std::vector<nas_vif_pkt_reader_t> readers;
+    {
+        std_rw_lock_write_guard l(&ports_lock);
+        for (auto &it : g_vif_pkt_tx._tap_fd_to_event_info_map) {
+            event_del(it.second);
+            event_free(it.second);
         }
-        pkt_count++;
-        /* send packet for transmission to registered callback function with registered packet buffer */
-        g_vif_pkt_tx.egress_tx_cb(npu,port,g_vif_pkt_tx.tx_buf,pkt_len);
+        g_vif_pkt_tx._tap_fd_to_event_info_map.clear();
+        readers = std::move(g_vif_pkt_tx.readers);
+        g_vif_pkt_tx.readers.clear();
     }
+    for (size_t ix = 1; ix < readers.size(); ++ix) {
+        event_base_loopbreak(readers[ix].evt_base);
+        pthread_join(readers[ix].thr, NULL);
+    }
+    nas_vif_readers_free(readers);
 }
 
+static void * nas_vif_reader_main (void *arg)
+{
+    _cur_reader = (nas_vif_pkt_reader_t *) arg;
+
+    if (event_base_dispatch(_cur_reader->evt_base) != 0) {
+        EV_LOGGING(INTERFACE,ERR,"TAP-TX", "NAS Packet reader %lu event dispatch failed.",
+                   _cur_reader->id);
+    }
+    return NULL;
+}
 
 /* packet transmission from virtual interface is handled via libevent.
  * call to hal_virtual_interface_wait() trigger event dispatcher.
+ * The tap queues are served by a pool of reader threads (see nas_pkt_io_cfg_t),
+ * the calling thread runs reader 0 which also handles the nflog fd.
  */
 t_std_error hal_virtual_interface_wait (hal_virt_pkt_transmit tx_fun,
+                                        hal_virt_pkt_transmit_burst tx_burst_fun,
                                         hal_virt_pkt_transmit_to_ingress_pipeline tx_to_ingress_fun,
                                         hal_virt_pkt_transmit_to_ingress_pipeline_hybrid tx_to_ingress_hybrid_fun,
                                         void *data, unsigned int len)
@@ -843,6 +1216,7 @@ t_std_error hal_virtual_interface_wait (hal_virt_pkt_transmit tx_fun,
     g_vif_pkt_tx.nas_nflog_fd = -1;
 
     g_vif_pkt_tx.egress_tx_cb = tx_fun;
+    g_vif_pkt_tx.egress_tx_burst_cb = tx_burst_fun;
     g_vif_pkt_tx.tx_to_ingress_fun = tx_to_ingress_fun;
     g_vif_pkt_tx.tx_to_ingress_hybrid_fun = tx_to_ingress_hybrid_fun;
     g_vif_pkt_tx.tx_buf = data;
@@ -853,18 +1227,23 @@ t_std_error hal_virtual_interface_wait (hal_virt_pkt_transmit tx_fun,
         return STD_ERR(INTERFACE,FAIL,0);
     }
 
-    /* initialize event base */
-    g_vif_pkt_tx.nas_evt_base = event_base_new();
-    if (!g_vif_pkt_tx.nas_evt_base)
-    {
-        EV_LOGGING(INTERFACE,ERR,"TAP-TX", "NAS Packet event base initialization failed.");
-        return STD_ERR(INTERFACE,FAIL,0);
+    /* initialize the event base of each reader */
+    size_t num_readers = nas_pkt_io_cfg_get()->tap_reader_threads;
+    std::vector<nas_vif_pkt_reader_t> readers(num_readers);
+    for (size_t ix = 0; ix < num_readers; ++ix) {
+        if (nas_vif_reader_init(&readers[ix], ix, (ix == 0) ? data : NULL, len) != STD_ERR_OK) {
+            nas_vif_readers_free(readers);
+            return STD_ERR(INTERFACE,FAIL,0);
+        }
     }
+    /* nflog and SIGINT are handled by reader 0 on the calling thread */
+    g_vif_pkt_tx.nas_evt_base = readers[0].evt_base;
 
     g_vif_pkt_tx.nas_nflog_fd = nas_os_nl_nflog_init ();
     if (g_vif_pkt_tx.nas_nflog_fd == -1)
     {
         EV_LOGGING(INTERFACE,ERR,"TAP-TX", "NAS NFLOG Packet read initialization failed.");
+        nas_vif_readers_free(readers);
         return STD_ERR(INTERFACE,FAIL,0);
     }
 
@@ -876,6 +1255,7 @@ t_std_error hal_virtual_interface_wait (hal_virt_pkt_transmit tx_fun,
     if (!g_vif_pkt_tx.nas_nflog_fd_ev) {
         EV_LOGGING(INTERFACE,ERR,"TAP-TX", "NAS Packet read event create failed for nflog fd (%d).",
                    g_vif_pkt_tx.nas_nflog_fd);
+        nas_vif_readers_free(readers);
         return STD_ERR(INTERFACE,FAIL,0);
     }
 
@@ -883,6 +1263,7 @@ t_std_error hal_virtual_interface_wait (hal_virt_pkt_transmit tx_fun,
         EV_LOGGING(INTERFACE,ERR,"TAP-TX", "NAS Packet read event add failed for nflog fd (%d).",
                    g_vif_pkt_tx.nas_nflog_fd);
         event_free (g_vif_pkt_tx.nas_nflog_fd_ev);
+        nas_vif_readers_free(readers);
         return STD_ERR(INTERFACE,FAIL,0);
     }
 
@@ -895,13 +1276,45 @@ t_std_error hal_virtual_interface_wait (hal_virt_pkt_transmit tx_fun,
         EV_LOGGING(INTERFACE,ERR,"TAP-TX", "NAS Packet signal event initialization failed.");
         event_del (g_vif_pkt_tx.nas_nflog_fd_ev);
         event_free (g_vif_pkt_tx.nas_nflog_fd_ev);
+        nas_vif_readers_free(readers);
         return STD_ERR(INTERFACE,FAIL,0);
     }
 
+    /* start the other readers, each dispatching its own event base. They are
+     * started last so the init error paths above only free the pool. Taps are
+     * sharded over the readers in the pool, so a reader whose thread can't be
+     * started is dropped from the pool before any tap gets registered.
+     */
+    for (size_t ix = 1; ix < readers.size(); ++ix) {
+        nas_vif_pkt_reader_t *reader = &readers[ix];
+        int error = pthread_create(&reader->thr, NULL, nas_vif_reader_main, reader);
+        if (error) {
+            EV_LOGGING(INTERFACE,ERR,"TAP-TX", "NAS Packet reader %lu thread create failed: %s,"
+                       " running with %lu readers", ix, strerror(error), ix);
+            for (size_t unused = ix; unused < readers.size(); ++unused) {
+                nas_vif_reader_free(&readers[unused]);
+            }
+            readers.resize(ix);
+            break;
+        }
+        char thr_name[16];
+        snprintf(thr_name, sizeof(thr_name), "hal_pkt_rdr%lu", ix);
+        pthread_setname_np(reader->thr, thr_name);
+    }
+    {
+        /* taps are registered with the readers under the ports lock; moving
+         * the vector keeps the readers where the started threads see them
+         */
+        std_rw_lock_write_guard l(&ports_lock);
+        g_vif_pkt_tx.readers = std::move(readers);
+    }
+
     /* dispatch the event loop; to dispatch event loop there should be atleast
      * one active event. events for tap interfaces will get added from NAS
      * only after ports are oper up, so SIGINT event is registered as an event at start.
      */
+    _cur_reader = &g_vif_pkt_tx.readers[0];
+    t_std_error rc = STD_ERR_OK;
     if (event_base_dispatch(g_vif_pkt_tx.nas_evt_base) != 0) {
         EV_LOGGING(INTERFACE,ERR,"TAP-TX", "NAS Packet event dispath failed...Aborting...");
         event_del (g_vif_pkt_tx.nas_signal_event);
@@ -909,28 +1322,47 @@ t_std_error hal_virtual_interface_wait (hal_virt_pkt_transmit tx_fun,
         //@@TODO de-init nas_nflog_fd on failure
         event_del (g_vif_pkt_tx.nas_nflog_fd_ev);
         event_free (g_vif_pkt_tx.nas_nflog_fd_ev);
-        event_base_free (g_vif_pkt_tx.nas_evt_base);
-        return STD_ERR(INTERFACE,FAIL,0);
+        rc = STD_ERR(INTERFACE,FAIL,0);
     }
-    return STD_ERR_OK;
+
+    /* reader 0 is done, stop the other readers too */
+    nas_vif_readers_stop();
+    return rc;
 }
 
 t_std_error hal_virtual_interface_send(npu_id_t npu, npu_port_t port, int queue,
                                        const void * data, unsigned int len) {
-    int fd = -1;
-    {
-        std_rw_lock_read_guard l(&ports_lock);
-        if (_ports[npu][port]->link_state()!=IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_UP) {
-            return STD_ERR_OK;
-        }
-        fd = swp_util_tap_descr_get_queue(_ports[npu][port]->tap(), queue);
+    //ports lock keeps the tap writer (and its fd) around for the write
+    std_rw_lock_read_guard l(&ports_lock);
+
+    CNasPortDetails *details = _ports[npu][port];
+    if (details->link_state()!=IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_UP) {
+        return STD_ERR_OK;
     }
 
-    if (fd!=-1) {
-        int l = write(fd,data,len);
-        if (((int)len)!=l) return STD_ERR(INTERFACE,FAIL,errno);
+    size_t q = (queue < 0) ?
+            tap_rx_queue_select((const uint8_t *) data, len, details->wr_queue_count()) :
+            (size_t) queue;
+    nas_tap_wr_queue_t *wq = details->wr_queue(q);
+    if (wq == nullptr) return STD_ERR_OK;
+
+    return tap_wr_queue_send(wq, data, len);
+}
+
+void hal_virtual_interface_dbg_counters(void) {
+    std_rw_lock_read_guard l(&ports_lock);
+
+    printf("\rTAP RX COUNTERS (npu:port ifindex written backlogged dropped-full dropped-err)\r\n");
+    for (npu_id_t npu = 0; npu < (npu_id_t) _ports.npus(); ++npu) {
+        for (port_t port = 0; port < _ports[npu].size(); ++port) {
+            const CNasPortDetails *details = _ports[npu][port];
+            if (!details->valid()) continue;
+            const nas_tap_rx_stats_t& stats = details->rx_stats();
+            printf("\r%d:%u %d %llu %llu %llu %llu\r\n", npu, port, details->ifindex(),
+                   (unsigned long long) stats.written, (unsigned long long) stats.backlogged,
+                   (unsigned long long) stats.dropped_full, (unsigned long long) stats.dropped_err);
+        }
     }
-    return STD_ERR_OK;
 }
 
 static bool nas_int_port_mapped(const char* name)
@@ -972,13 +1404,32 @@ bool nas_int_port_name_used(const char *name) {
     return nas_int_port_used_int(name, 0, 0, false);
 }
 
+/* Called per packet from the RX/sFlow paths - no lock, no syscall */
 bool nas_int_port_ifindex (npu_id_t npu, port_t port, hal_ifindex_t *ifindex) {
+    return _ports.cached_ifindex(npu, port, ifindex);
+}
+
+size_t nas_int_port_info_list (nas_int_port_info_t *list, size_t max) {
     std_rw_lock_read_guard l(&ports_lock);
-    if (!nas_int_port_used_int(nullptr, npu, port, true)) {
-        return false;
+
+    size_t count = 0;
+    for (npu_id_t npu = 0; npu < (npu_id_t) _ports.npus(); ++npu) {
+        for (port_t port = 0; port < _ports[npu].size(); ++port) {
+            hal_ifindex_t ifindex = 0;
+            if (!_ports.cached_ifindex(npu, port, &ifindex)) continue;
+
+            if (count < max) {
+                list[count].npu = npu;
+                list[count].port = port;
+                list[count].ifindex = ifindex;
+                safestrncpy(list[count].name,
+                            swp_util_tap_descr_get_name(_ports[npu][port]->tap()),
+                            sizeof(list[count].name));
+            }
+            ++count;
+        }
     }
-    *ifindex = _ports[npu][port]->ifindex ();
-    return true;
+    return count;
 }
 
 void nas_int_port_link_change(npu_id_t npu, port_t port,
@@ -1015,7 +1466,7 @@ static t_std_error nas_int_port_create_int(npu_id_t npu, port_t port, const char
     }
     _ports[name].create(name);
     if (mapped) {
-        _ports[npu][port] = &_ports[name];
+        _ports.map(npu, port, &_ports[name]);
     }
 
     interface_ctrl_t details;
@@ -1037,7 +1488,7 @@ static t_std_error nas_int_port_create_int(npu_id_t npu, port_t port, const char
         EV_LOGGING(INTERFACE,ERR,"INT-CREATE", "Not created %d:%d:%s - mapping error",
                         (int)npu,(int)port,name);
         if (mapped) {
-            _ports[npu][port] = _ports.dummy_port();
+            _ports.map(npu, port, _ports.dummy_port());
         }
         _ports.erase(name);
         return STD_ERR(INTERFACE,FAIL,0);
@@ -1084,7 +1535,7 @@ t_std_error nas_int_port_delete(const char *name) {
     if (port_info.mapped()) {
         npu_id_t npu = port_info.npu();
         port_t port = port_info.port();
-        _ports[npu][port] = _ports.dummy_port();
+        _ports.map(npu, port, _ports.dummy_port());
     }
     _ports[name].del();
     _ports.erase(name);
@@ -1096,13 +1547,13 @@ t_std_error nas_int_port_init(void) {
 
     std_rw_lock_write_guard l(&ports_lock);
     size_t npus = 1; //!@TODO get the maximum ports
-
-    _ports.resize(npus);
+    size_t max_ports = 0;
 
     for ( size_t npu_ix = 0; npu_ix < npus ; ++npu_ix ) {
         size_t port_mx = ndi_max_npu_port_get(npu_ix)*4;
-        _ports[npu_ix].assign(port_mx, _ports.dummy_port());
+        if (port_mx > max_ports) max_ports = port_mx;
     }
+    _ports.resize(npus, max_ports);
     return STD_ERR_OK;
 }
 
@@ -1114,7 +1565,12 @@ void nas_dbg_dump_tap_fd_to_nas_port_map_tbl ()
     std_rw_lock_read_guard l(&ports_lock);
 
     for (auto &it: g_vif_pkt_tx._tap_fd_to_event_info_map) {
-        printf ("\rFD: %d \r\n", it.first);
+        struct event_base *base = event_get_base(it.second);
+        size_t reader_ix = 0;
+        for (; reader_ix < g_vif_pkt_tx.readers.size(); ++reader_ix) {
+            if (g_vif_pkt_tx.readers[reader_ix].evt_base == base) break;
+        }
+        printf ("\rFD: %d reader: %lu \r\n", it.first, reader_ix);
     }
 
     return;
@@ -1122,18 +1578,26 @@ void nas_dbg_dump_tap_fd_to_nas_port_map_tbl ()
 
 void nas_nflog_dbg_counters ()
 {
+    nas_pkt_io_stats_t *stats = new nas_pkt_io_stats_t;
+    nas_pkt_io_stats_get(stats);
+
     printf("\rNAS NFLOG DEBUG COUNTERS\r\n");
     printf("\r========================\r\n");
-    printf("\rTotal packets received                        : %d\r\n",
-           nas_nflog_pkts_tx_to_ingress_pipeline);
-    printf("\rTotal flood packets dropped                   : %d\r\n",
-           nas_nflog_pkts_tx_to_ingress_pipeline_dropped);
+    printf("\rTotal packets received                        : %llu\r\n",
+           (unsigned long long) stats->cnt[NAS_PKT_IO_CNT_NFLOG_TX_LOOKUP]);
+    printf("\rTotal flood packets dropped                   : %llu\r\n",
+           (unsigned long long) (stats->drop[NAS_PKT_IO_DROP_NFLOG_NO_PAYLOAD] +
+                                 stats->drop[NAS_PKT_IO_DROP_NFLOG_NO_INTF] +
+                                 stats->drop[NAS_PKT_IO_DROP_NFLOG_FLOOD]));
+    delete stats;
 }
 
 void nas_nflog_dbg_reset_counters ()
 {
-    nas_nflog_pkts_tx_to_ingress_pipeline = 0;
-    nas_nflog_pkts_tx_to_ingress_pipeline_dropped = 0;
+    nas_pkt_io_stats_clear_cnt(NAS_PKT_IO_CNT_NFLOG_TX_LOOKUP);
+    nas_pkt_io_stats_clear_drop(NAS_PKT_IO_DROP_NFLOG_NO_PAYLOAD);
+    nas_pkt_io_stats_clear_drop(NAS_PKT_IO_DROP_NFLOG_NO_INTF);
+    nas_pkt_io_stats_clear_drop(NAS_PKT_IO_DROP_NFLOG_FLOOD);
 }
 
 static t_std_error update_if_reg_info(const char *name, npu_id_t npu, port_t port,
@@ -1206,12 +1670,12 @@ t_std_error nas_int_update_npu_port(const char *name, npu_id_t npu, port_t port,
 
     if (connect) {
         _ports[name].init(npu, port);
-        _ports[npu][port] = &_ports[name];
+        _ports.map(npu, port, &_ports[name]);
         ndi_intf_link_state_t link_state;
         if (ndi_port_link_state_get(npu, port, &link_state) != STD_ERR_OK) {
             EV_LOGGING(INTERFACE, ERR, "INT-UPDATE", "Failed to get link state for port %d",
                        port);
-            _ports[npu][port] = _ports.dummy_port();
+            _ports.map(npu, port, _ports.dummy_port());
             return STD_ERR(INTERFACE, FAIL, 0);
         }
         IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_t state =
@@ -1220,7 +1684,7 @@ t_std_error nas_int_update_npu_port(const char *name, npu_id_t npu, port_t port,
     } else {
         _ports[npu][port]->set_link_state(IF_INTERFACES_STATE_INTERFACE_OPER_STATUS_DOWN);
         _ports[name].init();
-        _ports[npu][port] = _ports.dummy_port();
+        _ports.map(npu, port, _ports.dummy_port());
 
         // Disable un-mapped NPU port to force its link down
         if (ndi_port_admin_state_set(npu, port, false) != STD_ERR_OK) {
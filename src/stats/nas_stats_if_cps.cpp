@@ -33,9 +33,11 @@
 #include "event_log.h"
 #include "nas_ndi_plat_stat.h"
 #include "nas_stats.h"
+#include "nas_stats_poller.h"
 #include "nas_fc_stats.h"
 #include "nas_ndi_port.h"
 #include "nas_int_utils.h"
+#include "nas_int_port.h"
 #include "std_utils.h"
 #include "vrf-mgmt.h"
 #include "dell-interface.h"
@@ -48,28 +50,36 @@
 #include <vector>
 #include <unordered_map>
 #include <stdint.h>
+#include <stddef.h>
 #include <algorithm>
 
-#define LPBK_STATS_PATH "/proc/net/dev"
 #define ARRAY_SIZE(a)   (sizeof(a)/sizeof((a)[0]))
-#define BUF_SIZE         1024
 static auto if_stat_ids = new std::vector<ndi_stat_id_t>;
 
 
 static const struct {
     char     name[32];
     uint64_t oid;
-    uint_t   index;
+    size_t   offset;    // in rtnl_link_stats64
 } stats_map[] = {
-    {"input_packets", DELL_IF_IF_INTERFACES_STATE_INTERFACE_STATISTICS_IN_PKTS, 1},
-    {"input_bytes", IF_INTERFACES_STATE_INTERFACE_STATISTICS_IN_OCTETS, 0},
-    {"input_multicast", IF_INTERFACES_STATE_INTERFACE_STATISTICS_IN_MULTICAST_PKTS, 7},
-    {"input_errors", IF_INTERFACES_STATE_INTERFACE_STATISTICS_IN_ERRORS, 2},
-    {"input_discards", IF_INTERFACES_STATE_INTERFACE_STATISTICS_IN_DISCARDS, 3},
-    {"output_packets", DELL_IF_IF_INTERFACES_STATE_INTERFACE_STATISTICS_OUT_PKTS, 9},
-    {"output_bytes", IF_INTERFACES_STATE_INTERFACE_STATISTICS_OUT_OCTETS, 8},
-    {"output_errors", IF_INTERFACES_STATE_INTERFACE_STATISTICS_OUT_ERRORS, 10},
-    {"output_discards",IF_INTERFACES_STATE_INTERFACE_STATISTICS_OUT_DISCARDS, 11}
+    {"input_packets", DELL_IF_IF_INTERFACES_STATE_INTERFACE_STATISTICS_IN_PKTS,
+        offsetof(struct rtnl_link_stats64, rx_packets)},
+    {"input_bytes", IF_INTERFACES_STATE_INTERFACE_STATISTICS_IN_OCTETS,
+        offsetof(struct rtnl_link_stats64, rx_bytes)},
+    {"input_multicast", IF_INTERFACES_STATE_INTERFACE_STATISTICS_IN_MULTICAST_PKTS,
+        offsetof(struct rtnl_link_stats64, multicast)},
+    {"input_errors", IF_INTERFACES_STATE_INTERFACE_STATISTICS_IN_ERRORS,
+        offsetof(struct rtnl_link_stats64, rx_errors)},
+    {"input_discards", IF_INTERFACES_STATE_INTERFACE_STATISTICS_IN_DISCARDS,
+        offsetof(struct rtnl_link_stats64, rx_dropped)},
+    {"output_packets", DELL_IF_IF_INTERFACES_STATE_INTERFACE_STATISTICS_OUT_PKTS,
+        offsetof(struct rtnl_link_stats64, tx_packets)},
+    {"output_bytes", IF_INTERFACES_STATE_INTERFACE_STATISTICS_OUT_OCTETS,
+        offsetof(struct rtnl_link_stats64, tx_bytes)},
+    {"output_errors", IF_INTERFACES_STATE_INTERFACE_STATISTICS_OUT_ERRORS,
+        offsetof(struct rtnl_link_stats64, tx_errors)},
+    {"output_discards",IF_INTERFACES_STATE_INTERFACE_STATISTICS_OUT_DISCARDS,
+        offsetof(struct rtnl_link_stats64, tx_dropped)}
 };
 
 bool
@@ -162,6 +172,56 @@ static t_std_error populate_if_stat_ids(){
     return STD_ERR_OK;
 }
 
+/* Counters and time stamps of a port, stat_values holds one entry per if_stat_ids */
+static void add_port_stats(cps_api_object_t obj, hal_ifindex_t ifindex, const char *if_name,
+                           const uint64_t *stat_values, uint64_t time_uptime,
+                           uint64_t time_from_epoch){
+
+    for(unsigned int ix = 0 ; ix < if_stat_ids->size() ; ++ix ){
+        cps_api_object_attr_add_u64(obj, if_stat_ids->at(ix), stat_values[ix]);
+    }
+
+    cps_api_object_set_timestamp(obj,time_from_epoch);
+    cps_api_object_attr_add_u32(obj, DELL_BASE_IF_CMN_IF_INTERFACES_STATE_INTERFACE_STATISTICS_TIME_STAMP,
+    		(uint32_t)time_uptime); // Used for measuring time intervals and rate calculations
+    cps_api_object_attr_add_u32(obj,IF_INTERFACES_STATE_INTERFACE_IF_INDEX, ifindex);
+    if (strlen(if_name) != 0)
+        cps_api_object_attr_add(obj, IF_INTERFACES_STATE_INTERFACE_NAME, if_name, strlen(if_name) + 1);
+}
+
+static bool read_port_stats(npu_id_t npu, npu_port_t port, uint64_t *stat_values){
+
+    const size_t max_port_stat_id = if_stat_ids->size();
+    memset(stat_values,0,max_port_stat_id * sizeof(uint64_t));
+
+    return ndi_port_stats_get(npu, port, (ndi_stat_id_t *)&(if_stat_ids->at(0)),
+                              stat_values,max_port_stat_id) == STD_ERR_OK;
+}
+
+static bool fill_port_stats(cps_api_object_t obj, npu_id_t npu, npu_port_t port,
+                            hal_ifindex_t ifindex, const char *if_name, uint64_t *stat_values,
+                            uint64_t time_uptime, uint64_t time_from_epoch){
+
+    if (!read_port_stats(npu, port, stat_values)) return false;
+
+    add_port_stats(obj, ifindex, if_name, stat_values, time_uptime, time_from_epoch);
+    return true;
+}
+
+/* Counters of a port from the poller snapshot, if the port is polled */
+static bool fill_port_stats_cached(cps_api_object_t obj, const nas_stats_snapshot_ptr& snap,
+                                   hal_ifindex_t ifindex){
+
+    if (snap == nullptr) return false;
+
+    auto it = snap->entries.find(ifindex);
+    if (it == snap->entries.end() || it->second.values.size() != if_stat_ids->size()) return false;
+
+    add_port_stats(obj, ifindex, it->second.name.c_str(), it->second.values.data(),
+                   snap->time_uptime, snap->time_from_epoch);
+    return true;
+}
+
 static bool get_stats(hal_ifindex_t ifindex, cps_api_object_list_t list){
 
     cps_api_object_t obj = cps_api_object_list_create_obj_and_append(list);
@@ -171,6 +231,9 @@ static bool get_stats(hal_ifindex_t ifindex, cps_api_object_list_t list){
         return false;
     }
 
+    if (fill_port_stats_cached(obj, nas_stats_poller_snapshot(NAS_STATS_GRP_PORT), ifindex)) {
+        return true;
+    }
 
     interface_ctrl_t intf_ctrl;
     memset(&intf_ctrl, 0, sizeof(interface_ctrl_t));
@@ -184,93 +247,79 @@ static bool get_stats(hal_ifindex_t ifindex, cps_api_object_list_t list){
         return false;
     }
 
-    const size_t max_port_stat_id = if_stat_ids->size();
-    uint64_t stat_values[max_port_stat_id];
-    memset(stat_values,0,sizeof(stat_values));
+    std::vector<uint64_t> stat_values(if_stat_ids->size());
 
-    if(ndi_port_stats_get(intf_ctrl.npu_id, intf_ctrl.port_id,
-                          (ndi_stat_id_t *)&(if_stat_ids->at(0)),
-                          stat_values,max_port_stat_id) != STD_ERR_OK) {
-        return false;
-    }
+    return fill_port_stats(obj, intf_ctrl.npu_id, intf_ctrl.port_id, ifindex, intf_ctrl.if_name,
+                           stat_values.data(), std_get_uptime(nullptr),
+                           std_time_get_current_from_epoch_in_nanoseconds());
+}
 
-    for(unsigned int ix = 0 ; ix < max_port_stat_id ; ++ix ){
-        cps_api_object_attr_add_u64(obj, if_stat_ids->at(ix), stat_values[ix]);
-    }
+/*
+ * Statistics of all ports in one pass: the port list (npu ordered) comes from
+ * the port table without an interface lookup per port, and one time stamp is
+ * used for the whole list so the rates of all ports cover the same interval.
+ */
+static bool get_stats_bulk(cps_api_object_list_t list){
+
+    size_t count = nas_int_port_info_list(nullptr, 0);
+    std::vector<nas_int_port_info_t> ports(count);
+    count = std::min(count, nas_int_port_info_list(ports.data(), ports.size()));
 
+    std::vector<uint64_t> stat_values(if_stat_ids->size());
     uint64_t time_uptime = std_get_uptime(nullptr);
     uint64_t time_from_epoch = std_time_get_current_from_epoch_in_nanoseconds();
-    cps_api_object_set_timestamp(obj,time_from_epoch);
-    cps_api_object_attr_add_u32(obj, DELL_BASE_IF_CMN_IF_INTERFACES_STATE_INTERFACE_STATISTICS_TIME_STAMP,
-    		(uint32_t)time_uptime); // Used for measuring time intervals and rate calculations
-    cps_api_object_attr_add_u32(obj,IF_INTERFACES_STATE_INTERFACE_IF_INDEX, ifindex);
-    if (strlen(intf_ctrl.if_name) != 0)
-        cps_api_object_attr_add(obj, IF_INTERFACES_STATE_INTERFACE_NAME, intf_ctrl.if_name, strlen(intf_ctrl.if_name) + 1);
+    nas_stats_snapshot_ptr snap = nas_stats_poller_snapshot(NAS_STATS_GRP_PORT);
 
-    return true;
-}
+    for (size_t ix = 0; ix < count; ++ix) {
+        cps_api_object_t obj = cps_api_object_list_create_obj_and_append(list);
+        if (obj == NULL) {
+            EV_LOG(ERR,INTERFACE, 0,"NAS-STAT", "Failed to create/append new object to list");
+            return false;
+        }
 
-static bool fill_cps_stats (cps_api_object_t obj, char *ptr, const char *name, const char *ifname) {
+        /* ports added since the last poll are read from the NPU */
+        if (fill_port_stats_cached(obj, snap, ports[ix].ifindex)) continue;
 
-    char *save_ptr, *p;
-    uint_t cnt = 0;
-    bool ret = true;
-    uint64_t   stats_arr[16];
-    memset(stats_arr, 0, sizeof(stats_arr));
-    if ((p = strstr(ptr, name)) == NULL) {
-        EV_LOGGING (NAS_INT_STATS, ERR ,"NAS-STAT", "lpbk :fill_cps_stats error");
-        return false;
-    }
-    p = strtok_r(p, " ", &save_ptr);
-    while (((p = strtok_r(NULL, " ", &save_ptr)) != NULL)
-        && (cnt < ARRAY_SIZE(stats_arr))) {
-        stats_arr[cnt++] = atoll(p);
-    }
-    for(unsigned int ix = 0 ; ix < ARRAY_SIZE(stats_map) ; ++ix ){
-       cps_api_object_attr_add_u64(obj, stats_map[ix].oid, stats_arr[stats_map[ix].index]);
+        /* NDI reads counters one port at a time */
+        if (!fill_port_stats(obj, ports[ix].npu, ports[ix].port, ports[ix].ifindex, ports[ix].name,
+                             stat_values.data(), time_uptime, time_from_epoch)) {
+            EV_LOGGING(NAS_INT_STATS, DEBUG, "NAS-STAT", "Failed to get stats of %s",
+                       ports[ix].name);
+            cps_api_object_list_remove(list, cps_api_object_list_size(list) - 1);
+            cps_api_object_delete(obj);
+        }
     }
-
-    uint64_t time_uptime = std_get_uptime(nullptr);
-    uint64_t time_from_epoch = std_time_get_current_from_epoch_in_nanoseconds();
-    cps_api_object_set_timestamp(obj,time_from_epoch); // For  retrieving time from epoch
-    cps_api_object_attr_add_u32(obj, DELL_BASE_IF_CMN_IF_INTERFACES_STATE_INTERFACE_STATISTICS_TIME_STAMP,
-    		(uint32_t)time_uptime); // Used for measuring time intervals
-    cps_api_object_attr_add(obj, IF_INTERFACES_STATE_INTERFACE_NAME, ifname, strlen(ifname) + 1);
-    return ret;
+    return true;
 }
 
 bool get_intf_stats_from_os( const char *name, cps_api_object_list_t list) {
 
-    char stats_buf[BUF_SIZE];
-    char intf_name[HAL_IF_NAME_SZ];
-    FILE *fp = NULL;
-    bool ret = false;
-
     cps_api_object_t obj = cps_api_object_list_create_obj_and_append(list);
 
     if (obj == NULL) {
         EV_LOGGING (NAS_INT_STATS, ERR ,"NAS-STAT", "lpbk: Failed to create/append new object to list");
-        return ret;
+        return false;
     }
 
-    if ((fp = fopen(LPBK_STATS_PATH, "r")) == NULL) {
-        return ret;
+    struct rtnl_link_stats64 stats;
+    if (!nas_stats_os_get_link_stats(name, &stats)) {
+        return false;
     }
+    /* discards are counted the way /proc/net/dev shows them */
+    stats.rx_dropped += stats.rx_missed_errors;
 
-    memset(stats_buf, 0, sizeof(stats_buf));
-
-    /* space at start and ':' at end will uniquely identify an interface*/
-    snprintf(intf_name, sizeof(intf_name), " %s%s", name, ":");
-
-    stats_buf[0] = ' ';
-    while (fgets(&stats_buf[1], sizeof(stats_buf) -1, fp) == &stats_buf[1]) {
-        if (strstr(stats_buf, intf_name) != NULL) {
-            ret = fill_cps_stats(obj, stats_buf, intf_name, name);
-            break;
-        }
+    for(unsigned int ix = 0 ; ix < ARRAY_SIZE(stats_map) ; ++ix ){
+       cps_api_object_attr_add_u64(obj, stats_map[ix].oid,
+               *(const uint64_t *)((const uint8_t *)&stats + stats_map[ix].offset));
     }
-    fclose(fp);
-    return ret;
+
+    uint64_t time_uptime = std_get_uptime(nullptr);
+    uint64_t time_from_epoch = std_time_get_current_from_epoch_in_nanoseconds();
+    cps_api_object_set_timestamp(obj,time_from_epoch); // For  retrieving time from epoch
+    cps_api_object_attr_add_u32(obj, DELL_BASE_IF_CMN_IF_INTERFACES_STATE_INTERFACE_STATISTICS_TIME_STAMP,
+    		(uint32_t)time_uptime); // Used for measuring time intervals
+    cps_api_object_attr_add(obj, IF_INTERFACES_STATE_INTERFACE_NAME, name, strlen(name) + 1);
+    return true;
 }
 
 
@@ -329,6 +378,14 @@ static cps_api_return_code_t if_stats_get (void * context, cps_api_get_params_t
 
     cps_api_object_t obj = cps_api_object_list_get(param->filters,ix);
 
+    /* no interface given - get all the ports */
+    if (cps_api_get_key_data(obj, IF_INTERFACES_STATE_INTERFACE_NAME) == NULL &&
+        cps_api_object_attr_get(obj, DELL_BASE_IF_CMN_IF_INTERFACES_INTERFACE_IF_INDEX) == NULL &&
+        cps_api_object_attr_get(obj, IF_INTERFACES_STATE_INTERFACE_IF_INDEX) == NULL) {
+        if (get_stats_bulk(param->list)) return cps_api_ret_code_OK;
+        return (cps_api_return_code_t)STD_ERR(INTERFACE,FAIL,0);
+    }
+
     hal_ifindex_t ifindex=0;
     if(!nas_stat_get_ifindex_from_obj(obj,&ifindex,false)){
         return (cps_api_return_code_t)STD_ERR(INTERFACE,CFG,0);
@@ -389,6 +446,7 @@ static cps_api_return_code_t if_stats_set (void * context, cps_api_transaction_p
                               del_stat_ids.size()) != STD_ERR_OK) {
             return cps_api_ret_code_ERR;;
         }
+        nas_stats_poller_reset(NAS_STATS_GRP_PORT, ifindex);
     }
 
     return cps_api_ret_code_OK;
@@ -434,6 +492,7 @@ static cps_api_return_code_t if_stats_clear (void * context, cps_api_transaction
     if(ndi_port_clear_all_stat(intf_ctrl.npu_id,intf_ctrl.port_id) != STD_ERR_OK) {
         return (cps_api_return_code_t)STD_ERR(INTERFACE,FAIL,0);
     }
+    nas_stats_poller_reset(NAS_STATS_GRP_PORT, ifindex);
 
     return cps_api_ret_code_OK;
 }
@@ -483,5 +542,20 @@ t_std_error nas_stats_if_init(cps_api_operation_handle_t handle) {
         return STD_ERR(INTERFACE,FAIL,0);
     }
 
+    auto read = [](nas_stats_obj_t& port, uint64_t *stat_values) {
+        return read_port_stats(port.npu, port.port, stat_values);
+    };
+    auto list = [](std::vector<nas_stats_obj_t>& objs) {
+        size_t count = nas_int_port_info_list(nullptr, 0);
+        std::vector<nas_int_port_info_t> ports(count);
+        count = std::min(count, nas_int_port_info_list(ports.data(), ports.size()));
+        for (size_t ix = 0; ix < count; ++ix) {
+            objs.push_back({ports[ix].ifindex, ports[ix].npu, ports[ix].port, ports[ix].name});
+        }
+    };
+    if (nas_stats_poller_register(NAS_STATS_GRP_PORT, if_stat_ids->size(), read, list) != STD_ERR_OK) {
+        EV_LOGGING (NAS_INT_STATS, ERR,"NAS-STATS-INIT", "Failed to start the port stats poller");
+    }
+
     return STD_ERR_OK;
 }
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: nas_stats_os.cpp
+ *
+ * Kernel interface counters read with a netlink RTM_GETLINK request for the
+ * one interface asked for, instead of scanning /proc/net/dev.
+ */
+
+#include "nas_stats.h"
+#include "event_log.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#define NAS_STATS_OS_NL_BUF_SZ      (32*1024)
+#define NAS_STATS_OS_NL_TIMEOUT_S   1
+
+/* One socket per thread, the CPS handlers may run on several threads */
+static thread_local int _nl_sock = -1;
+static thread_local uint32_t _nl_seq = 0;
+
+static int nas_stats_os_nl_sock(void) {
+
+    if (_nl_sock >= 0) return _nl_sock;
+
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0) {
+        EV_LOGGING (NAS_INT_STATS, ERR, "NAS-STAT", "Failed to open netlink socket %d", errno);
+        return -1;
+    }
+
+    struct sockaddr_nl sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.nl_family = AF_NETLINK;
+
+    struct timeval tv = { NAS_STATS_OS_NL_TIMEOUT_S, 0 };
+    if (bind(fd, (struct sockaddr *)&sa, sizeof(sa)) < 0 ||
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) < 0) {
+        EV_LOGGING (NAS_INT_STATS, ERR, "NAS-STAT", "Failed to set up netlink socket %d", errno);
+        close(fd);
+        return -1;
+    }
+    _nl_sock = fd;
+    return fd;
+}
+
+/* returns 1 when the reply was found, 0 to read on and -1 on error */
+static int nas_stats_os_parse(struct nlmsghdr *nh, int len, uint32_t seq,
+                              struct rtnl_link_stats64 *stats) {
+
+    for (; NLMSG_OK(nh, len); nh = NLMSG_NEXT(nh, len)) {
+        // Replies to an earlier request that timed out are skipped
+        if (nh->nlmsg_seq != seq) continue;
+        if (nh->nlmsg_type == NLMSG_ERROR) return -1;
+        if (nh->nlmsg_type != RTM_NEWLINK) continue;
+
+        struct ifinfomsg *ifi = (struct ifinfomsg *)NLMSG_DATA(nh);
+        int attr_len = IFLA_PAYLOAD(nh);
+        for (struct rtattr *rta = IFLA_RTA(ifi); RTA_OK(rta, attr_len);
+             rta = RTA_NEXT(rta, attr_len)) {
+            if (rta->rta_type != IFLA_STATS64) continue;
+
+            // Older kernels report fewer counters, the rest stay 0
+            size_t sz = RTA_PAYLOAD(rta);
+            memcpy(stats, RTA_DATA(rta), sz < sizeof(*stats) ? sz : sizeof(*stats));
+            return 1;
+        }
+        return -1;
+    }
+    return 0;
+}
+
+bool nas_stats_os_get_link_stats(const char *name, struct rtnl_link_stats64 *stats) {
+
+    unsigned int ifindex = if_nametoindex(name);
+    if (ifindex == 0) {
+        EV_LOGGING (NAS_INT_STATS, ERR, "NAS-STAT", "No kernel interface %s", name);
+        return false;
+    }
+
+    int fd = nas_stats_os_nl_sock();
+    if (fd < 0) return false;
+
+    struct {
+        struct nlmsghdr nh;
+        struct ifinfomsg ifi;
+    } req;
+    memset(&req, 0, sizeof(req));
+    req.nh.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    req.nh.nlmsg_type = RTM_GETLINK;
+    req.nh.nlmsg_flags = NLM_F_REQUEST;
+    req.nh.nlmsg_seq = ++_nl_seq;
+    req.ifi.ifi_family = AF_UNSPEC;
+    req.ifi.ifi_index = ifindex;
+
+    if (send(fd, &req, req.nh.nlmsg_len, 0) < 0) {
+        EV_LOGGING (NAS_INT_STATS, ERR, "NAS-STAT", "Failed to request stats of %s %d", name, errno);
+        return false;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    static thread_local char buf[NAS_STATS_OS_NL_BUF_SZ] __attribute__((aligned(NLMSG_ALIGNTO)));
+    while (true) {
+        ssize_t len = recv(fd, buf, sizeof(buf), 0);
+        if (len < 0) {
+            if (errno == EINTR) continue;
+            EV_LOGGING (NAS_INT_STATS, ERR, "NAS-STAT", "Failed to get stats of %s %d", name, errno);
+            return false;
+        }
+        int rc = nas_stats_os_parse((struct nlmsghdr *)buf, (int)len, req.nh.nlmsg_seq, stats);
+        if (rc != 0) return rc > 0;
+    }
+}
@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * nas_stats_poller.cpp
+ */
+
+#include "nas_stats_poller.h"
+
+#include "event_log.h"
+#include "hal_shell.h"
+#include "std_config_node.h"
+#include "std_time_tools.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_set>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define NAS_STATS_POLL_MIN_MS       100
+#define NAS_STATS_POLL_MAX_MS       3600000
+/* watched objects not read for that many polls are no longer polled */
+#define NAS_STATS_WATCH_IDLE_POLLS  10
+
+typedef struct {
+    uint64_t interval_ms;       // 0 - not polled
+    uint64_t max_stale_ms;
+} nas_stats_grp_cfg_t;
+
+struct nas_stats_grp_ctx_t {
+    const char *name;
+    nas_stats_grp_cfg_t cfg;
+
+    /* set once at registration */
+    bool registered = false;
+    size_t stat_count = 0;
+    nas_stats_read_fn read;
+    nas_stats_list_fn list;
+
+    /* poller thread only */
+    uint64_t next_poll_ms = 0;
+    std::shared_ptr<nas_stats_snapshot_t> cur;      // published snapshot
+    std::shared_ptr<nas_stats_snapshot_t> spare;    // previous one, refilled by the next poll
+    std::vector<nas_stats_obj_t> objs;
+
+    uint64_t polls = 0;
+    uint64_t read_errors = 0;
+
+    /* protects watched, reset and publishing */
+    std::mutex mtx;
+    std::unordered_map<hal_ifindex_t, uint64_t> watched;    // ifindex -> poll when last read
+    std::unordered_set<hal_ifindex_t> reset;
+    std::shared_ptr<const nas_stats_snapshot_t> pub;        // std::atomic_load/store only
+};
+
+static nas_stats_grp_ctx_t _grps[NAS_STATS_GRP_MAX];
+
+static std::mutex _poller_mtx;
+static std::condition_variable _poller_cv;
+static bool _poller_running = false;
+
+static uint64_t _stats_now_ms()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static uint64_t _cfg_attr_get_num(std_config_node_t node, const char *attr,
+                                  uint64_t min, uint64_t max, uint64_t def)
+{
+    const char *val = std_config_attr_get(node, attr);
+    if (val == NULL) return def;
+
+    uint64_t num = strtoull(val, NULL, 0);
+    if (num != 0 && (num < min || num > max)) {
+        EV_LOGGING(NAS_INT_STATS, ERR, "NAS-STATS-POLL", "Invalid %s value %s, using %llu",
+                   attr, val, (unsigned long long) def);
+        return def;
+    }
+    return num;
+}
+
+static void _stats_cfg_load(void)
+{
+    _grps[NAS_STATS_GRP_PORT].name = "port";
+    _grps[NAS_STATS_GRP_VLAN].name = "vlan";
+
+    std_config_hdl_t _hdl = std_config_load(NAS_STATS_CFG_FILE);
+    if (_hdl == NULL) {
+        EV_LOGGING(NAS_INT_STATS, INFO, "NAS-STATS-POLL", "No stats config file, poller disabled");
+        return;
+    }
+    std_config_node_t _node = std_config_get_root(_hdl);
+    if (_node == NULL) {
+        std_config_unload(_hdl);
+        return;
+    }
+    for (_node = std_config_get_child(_node); _node != NULL ; _node = std_config_next_node(_node)) {
+        const char *name = std_config_name_get(_node);
+        if (name == NULL || strcmp(name, "poller") != 0) continue;
+
+        const char *grp_name = std_config_attr_get(_node, "group");
+        if (grp_name == NULL) continue;
+
+        for (auto& grp : _grps) {
+            if (strcmp(grp.name, grp_name) != 0) continue;
+
+            grp.cfg.interval_ms = _cfg_attr_get_num(_node, "interval-ms",
+                    NAS_STATS_POLL_MIN_MS, NAS_STATS_POLL_MAX_MS, 0);
+            grp.cfg.max_stale_ms = _cfg_attr_get_num(_node, "max-staleness-ms",
+                    NAS_STATS_POLL_MIN_MS, NAS_STATS_POLL_MAX_MS, 0);
+            //By default a snapshot may miss one poll
+            if (grp.cfg.max_stale_ms == 0) grp.cfg.max_stale_ms = 2 * grp.cfg.interval_ms;
+
+            EV_LOGGING(NAS_INT_STATS, INFO, "NAS-STATS-POLL", "Group %s interval %llu ms, "
+                       "max staleness %llu ms", grp.name,
+                       (unsigned long long) grp.cfg.interval_ms,
+                       (unsigned long long) grp.cfg.max_stale_ms);
+        }
+    }
+    std_config_unload(_hdl);
+}
+
+static void _stats_cfg_get(void)
+{
+    static std::once_flag _loaded;
+    std::call_once(_loaded, _stats_cfg_load);
+}
+
+static void _grp_poll(nas_stats_grp_ctx_t& grp, uint64_t now_ms)
+{
+    //Refill the previous snapshot unless a reader still holds it
+    std::shared_ptr<nas_stats_snapshot_t> snap;
+    if (grp.spare != nullptr && grp.spare.use_count() == 1) {
+        snap = std::move(grp.spare);
+    } else {
+        snap = std::make_shared<nas_stats_snapshot_t>();
+    }
+    grp.spare.reset();
+
+    grp.objs.clear();
+    if (grp.list) grp.list(grp.objs);
+
+    uint64_t gen = 0;
+    {
+        std::lock_guard<std::mutex> l(grp.mtx);
+        gen = ++grp.polls;
+        for (auto it = grp.watched.begin(); it != grp.watched.end(); ) {
+            if (gen - it->second > NAS_STATS_WATCH_IDLE_POLLS) {
+                it = grp.watched.erase(it);
+                continue;
+            }
+            grp.objs.push_back({it->first, 0, 0, ""});
+            ++it;
+        }
+    }
+
+    const nas_stats_snapshot_t *prev = grp.cur.get();
+    snap->poll_ms = now_ms;
+    snap->interval_ms = prev != nullptr ? now_ms - prev->poll_ms : 0;
+    snap->time_uptime = std_get_uptime(nullptr);
+    snap->time_from_epoch = std_time_get_current_from_epoch_in_nanoseconds();
+
+    for (auto& obj : grp.objs) {
+        nas_stats_entry_t& e = snap->entries[obj.ifindex];
+        if (e.gen == gen) continue;     // listed and watched
+
+        e.values.assign(grp.stat_count, 0);
+        if (!grp.read(obj, e.values.data())) {
+            ++grp.read_errors;
+            continue;
+        }
+        e.gen = gen;
+        e.name = obj.name;
+        e.deltas.assign(grp.stat_count, 0);
+        e.rates.assign(grp.stat_count, 0);
+
+        const nas_stats_entry_t *p_e = nullptr;
+        if (prev != nullptr) {
+            auto p_it = prev->entries.find(obj.ifindex);
+            if (p_it != prev->entries.end()) p_e = &p_it->second;
+        }
+        e.has_delta = p_e != nullptr && snap->interval_ms != 0;
+        if (!e.has_delta) continue;
+
+        const std::vector<uint64_t>& p_values = p_e->values;
+        for (size_t ix = 0; ix < grp.stat_count && ix < p_values.size(); ++ix) {
+            //Unsigned subtraction gives the right delta across a 64 bit wrap
+            e.deltas[ix] = e.values[ix] - p_values[ix];
+            e.rates[ix] = e.deltas[ix] * 1000 / snap->interval_ms;
+        }
+    }
+
+    for (auto it = snap->entries.begin(); it != snap->entries.end(); ) {
+        if (it->second.gen != gen) it = snap->entries.erase(it);
+        else ++it;
+    }
+
+    {
+        std::lock_guard<std::mutex> l(grp.mtx);
+        //Counters cleared while polling; leave them out until the next poll
+        for (auto ifindex : grp.reset) snap->entries.erase(ifindex);
+        grp.reset.clear();
+        std::atomic_store(&grp.pub, std::shared_ptr<const nas_stats_snapshot_t>(snap));
+    }
+
+    grp.spare = std::move(grp.cur);
+    grp.cur = std::move(snap);
+}
+
+static void *_stats_poller_main(void *arg)
+{
+    std::unique_lock<std::mutex> l(_poller_mtx);
+    while (true) {
+        uint64_t now_ms = _stats_now_ms();
+        uint64_t next_ms = now_ms + NAS_STATS_POLL_MAX_MS;
+
+        for (auto& grp : _grps) {
+            if (!grp.registered) continue;
+            if (grp.next_poll_ms <= now_ms) {
+                l.unlock();
+                _grp_poll(grp, now_ms);
+                l.lock();
+                grp.next_poll_ms = now_ms + grp.cfg.interval_ms;
+            }
+            if (grp.next_poll_ms < next_ms) next_ms = grp.next_poll_ms;
+        }
+
+        uint64_t after_ms = _stats_now_ms();
+        if (next_ms > after_ms) {
+            _poller_cv.wait_for(l, std::chrono::milliseconds(next_ms - after_ms));
+        }
+    }
+    return NULL;
+}
+
+static void _stats_poller_dump(std_parsed_string_t handle)
+{
+    size_t ix = 0;
+    const char *grp_name = std_parse_string_next(handle, &ix);
+    const char *ifindex_str = std_parse_string_next(handle, &ix);
+    uint64_t now_ms = _stats_now_ms();
+
+    for (auto& grp : _grps) {
+        if (!grp.registered) continue;
+        if (grp_name != NULL && strcmp(grp_name, grp.name) != 0) continue;
+
+        nas_stats_snapshot_ptr snap = std::atomic_load(&grp.pub);
+        size_t watched = 0;
+        {
+            std::lock_guard<std::mutex> l(grp.mtx);
+            watched = grp.watched.size();
+        }
+        printf("Group %s: interval %llu ms, max staleness %llu ms, objects %lu (watched %lu), "
+               "read errors %llu, last poll %lld ms ago\n", grp.name,
+               (unsigned long long) grp.cfg.interval_ms, (unsigned long long) grp.cfg.max_stale_ms,
+               snap != nullptr ? snap->entries.size() : 0, watched,
+               (unsigned long long) grp.read_errors,
+               snap != nullptr ? (long long) (now_ms - snap->poll_ms) : -1LL);
+
+        if (snap == nullptr || ifindex_str == NULL) continue;
+
+        auto it = snap->entries.find((hal_ifindex_t) strtoul(ifindex_str, NULL, 0));
+        if (it == snap->entries.end()) {
+            printf("Interface %s not polled\n", ifindex_str);
+            continue;
+        }
+        const nas_stats_entry_t& e = it->second;
+        printf("%s over %llu ms\n", e.name.c_str(), (unsigned long long) snap->interval_ms);
+        printf("%-8s %-20s %-20s %s\n", "COUNTER", "VALUE", "DELTA", "RATE/SEC");
+        for (size_t c_ix = 0; c_ix < e.values.size(); ++c_ix) {
+            printf("%-8lu %-20llu %-20llu %llu\n", c_ix, (unsigned long long) e.values[c_ix],
+                   (unsigned long long) e.deltas[c_ix], (unsigned long long) e.rates[c_ix]);
+        }
+    }
+}
+
+static t_std_error _stats_poller_start(void)
+{
+    pthread_t thr;
+    int err = pthread_create(&thr, NULL, _stats_poller_main, NULL);
+    if (err != 0) {
+        EV_LOGGING(NAS_INT_STATS, ERR, "NAS-STATS-POLL", "Failed to create poller thread %d", err);
+        return STD_ERR(INTERFACE, FAIL, err);
+    }
+    pthread_setname_np(thr, "nas_stats_poll");
+    pthread_detach(thr);
+
+    hal_shell_cmd_add("stats-poller", _stats_poller_dump,
+                      "[port|vlan] [ifindex] Displays the stats poller state, or the counters, "
+                      "deltas and rates of an interface");
+    return STD_ERR_OK;
+}
+
+t_std_error nas_stats_poller_register(nas_stats_grp_t grp_id, size_t stat_count,
+                                      nas_stats_read_fn read, nas_stats_list_fn list)
+{
+    _stats_cfg_get();
+    if (grp_id >= NAS_STATS_GRP_MAX) return STD_ERR(INTERFACE, PARAM, 0);
+
+    nas_stats_grp_ctx_t& grp = _grps[grp_id];
+    if (grp.cfg.interval_ms == 0) return STD_ERR_OK;
+
+    std::lock_guard<std::mutex> l(_poller_mtx);
+    if (!_poller_running) {
+        t_std_error rc = _stats_poller_start();
+        if (rc != STD_ERR_OK) return rc;
+        _poller_running = true;
+    }
+    grp.stat_count = stat_count;
+    grp.read = read;
+    grp.list = list;
+    grp.next_poll_ms = 0;
+    grp.registered = true;
+    _poller_cv.notify_one();
+
+    return STD_ERR_OK;
+}
+
+nas_stats_snapshot_ptr nas_stats_poller_snapshot(nas_stats_grp_t grp_id)
+{
+    if (grp_id >= NAS_STATS_GRP_MAX) return nullptr;
+    nas_stats_grp_ctx_t& grp = _grps[grp_id];
+    if (grp.cfg.interval_ms == 0) return nullptr;
+
+    nas_stats_snapshot_ptr snap = std::atomic_load(&grp.pub);
+    if (snap == nullptr || _stats_now_ms() - snap->poll_ms > grp.cfg.max_stale_ms) return nullptr;
+    return snap;
+}
+
+void nas_stats_poller_watch(nas_stats_grp_t grp_id, hal_ifindex_t ifindex)
+{
+    if (grp_id >= NAS_STATS_GRP_MAX) return;
+    nas_stats_grp_ctx_t& grp = _grps[grp_id];
+    if (grp.cfg.interval_ms == 0) return;
+
+    std::lock_guard<std::mutex> l(grp.mtx);
+    grp.watched[ifindex] = grp.polls;
+}
+
+void nas_stats_poller_reset(nas_stats_grp_t grp_id, hal_ifindex_t ifindex)
+{
+    if (grp_id >= NAS_STATS_GRP_MAX) return;
+    nas_stats_grp_ctx_t& grp = _grps[grp_id];
+    if (grp.cfg.interval_ms == 0) return;
+
+    std::lock_guard<std::mutex> l(grp.mtx);
+    grp.reset.insert(ifindex);
+
+    nas_stats_snapshot_ptr snap = std::atomic_load(&grp.pub);
+    if (snap == nullptr || snap->entries.count(ifindex) == 0) return;
+
+    //Clears are rare, publish a copy without the object
+    auto copy = std::make_shared<nas_stats_snapshot_t>(*snap);
+    copy->entries.erase(ifindex);
+    std::atomic_store(&grp.pub, std::shared_ptr<const nas_stats_snapshot_t>(copy));
+}
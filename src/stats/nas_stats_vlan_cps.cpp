@@ -33,6 +33,7 @@
 #include "event_log.h"
 #include "nas_ndi_plat_stat.h"
 #include "nas_stats.h"
+#include "nas_stats_poller.h"
 #include "nas_ndi_vlan.h"
 #include "ds_common_types.h"
 #include "nas_switch.h"
@@ -86,37 +87,18 @@ static t_std_error populate_vlan_stat_ids(){
 }
 
 
-static bool get_stats(hal_ifindex_t vlan_ifindex, cps_api_object_list_t list){
-
-    cps_api_object_t obj = cps_api_object_list_create_obj_and_append(list);
-
-    if (obj == NULL) {
-        EV_LOG(ERR,INTERFACE, 0,"NAS-STAT", "Failed to create/append new object to list");
-        return false;
-    }
-
-    interface_ctrl_t intf_ctrl;
-    memset(&intf_ctrl, 0, sizeof(interface_ctrl_t));
-
-    intf_ctrl.q_type = HAL_INTF_INFO_FROM_IF;
-    intf_ctrl.if_index = vlan_ifindex;
-
-    if (dn_hal_get_interface_info(&intf_ctrl) != STD_ERR_OK) {
-        EV_LOG(ERR,INTERFACE,0,"NAS-STAT","Interface %d has NO slot %d, port %d",
-               intf_ctrl.if_index, intf_ctrl.npu_id, intf_ctrl.port_id);
-        return false;
-    }
+/* VLAN counters added up over all the npus, total holds one entry per vlan_stat_ids */
+static bool read_vlan_stats(hal_vlan_id_t vlan_id, uint64_t *total_stat_values){
 
     const size_t vlan_stat_id_len = vlan_stat_ids->size();
     uint64_t stat_values[vlan_stat_id_len];
-    uint64_t total_stat_values[vlan_stat_id_len];
     memset(stat_values,0,sizeof(stat_values));
-    memset(total_stat_values,0,sizeof(total_stat_values));
+    memset(total_stat_values,0,vlan_stat_id_len * sizeof(uint64_t));
 
 
     for(auto it = npu_ids->begin(); it != npu_ids->end() ; ++it ){
 
-        if(ndi_vlan_stats_get(*it, intf_ctrl.vlan_id,
+        if(ndi_vlan_stats_get(*it, vlan_id,
                               (ndi_stat_id_t *)&(vlan_stat_ids->at(0)),
                               stat_values,vlan_stat_id_len) != STD_ERR_OK) {
             return false;
@@ -128,16 +110,65 @@ static bool get_stats(hal_ifindex_t vlan_ifindex, cps_api_object_list_t list){
 
         memset(stat_values,0,sizeof(stat_values));
     }
+    return true;
+}
+
+static bool get_vlan_intf_info(hal_ifindex_t vlan_ifindex, interface_ctrl_t *intf_ctrl){
+
+    memset(intf_ctrl, 0, sizeof(interface_ctrl_t));
+
+    intf_ctrl->q_type = HAL_INTF_INFO_FROM_IF;
+    intf_ctrl->if_index = vlan_ifindex;
+
+    if (dn_hal_get_interface_info(intf_ctrl) != STD_ERR_OK) {
+        EV_LOG(ERR,INTERFACE,0,"NAS-STAT","Interface %d has NO slot %d, port %d",
+               intf_ctrl->if_index, intf_ctrl->npu_id, intf_ctrl->port_id);
+        return false;
+    }
+    return true;
+}
+
+static void add_vlan_stats(cps_api_object_t obj, hal_ifindex_t vlan_ifindex, const char *if_name,
+                           const uint64_t *total_stat_values, time_t time_stamp){
 
-    for(unsigned int ix = 0 ; ix < vlan_stat_id_len ; ++ix ){
+    for(unsigned int ix = 0 ; ix < vlan_stat_ids->size() ; ++ix ){
          cps_api_object_attr_add_u64(obj, vlan_stat_ids->at(ix), total_stat_values[ix]);
     }
 
-    cps_api_object_attr_add_u32(obj,DELL_BASE_IF_CMN_IF_INTERFACES_STATE_INTERFACE_STATISTICS_TIME_STAMP,time(NULL));
+    cps_api_object_attr_add_u32(obj,DELL_BASE_IF_CMN_IF_INTERFACES_STATE_INTERFACE_STATISTICS_TIME_STAMP,time_stamp);
     cps_api_object_attr_add_u32(obj,IF_INTERFACES_STATE_INTERFACE_IF_INDEX, vlan_ifindex);
-    if(strlen(intf_ctrl.if_name) != 0)
-        cps_api_object_attr_add(obj, IF_INTERFACES_STATE_INTERFACE_NAME, intf_ctrl.if_name, strlen(intf_ctrl.if_name) + 1);
+    if(strlen(if_name) != 0)
+        cps_api_object_attr_add(obj, IF_INTERFACES_STATE_INTERFACE_NAME, if_name, strlen(if_name) + 1);
+}
+
+static bool get_stats(hal_ifindex_t vlan_ifindex, cps_api_object_list_t list){
+
+    cps_api_object_t obj = cps_api_object_list_create_obj_and_append(list);
+
+    if (obj == NULL) {
+        EV_LOG(ERR,INTERFACE, 0,"NAS-STAT", "Failed to create/append new object to list");
+        return false;
+    }
+
+    /* keep the VLAN polled while it is being read */
+    nas_stats_poller_watch(NAS_STATS_GRP_VLAN, vlan_ifindex);
+    nas_stats_snapshot_ptr snap = nas_stats_poller_snapshot(NAS_STATS_GRP_VLAN);
+    if (snap != nullptr) {
+        auto it = snap->entries.find(vlan_ifindex);
+        if (it != snap->entries.end() && it->second.values.size() == vlan_stat_ids->size()) {
+            add_vlan_stats(obj, vlan_ifindex, it->second.name.c_str(), it->second.values.data(),
+                           snap->time_from_epoch / 1000000000ULL);
+            return true;
+        }
+    }
+
+    interface_ctrl_t intf_ctrl;
+    if (!get_vlan_intf_info(vlan_ifindex, &intf_ctrl)) return false;
 
+    uint64_t total_stat_values[vlan_stat_ids->size()];
+    if (!read_vlan_stats(intf_ctrl.vlan_id, total_stat_values)) return false;
+
+    add_vlan_stats(obj, vlan_ifindex, intf_ctrl.if_name, total_stat_values, time(NULL));
     return true;
 }
 
@@ -202,5 +233,16 @@ t_std_error nas_stats_vlan_init(cps_api_operation_handle_t handle) {
         return STD_ERR(INTERFACE,FAIL,0);
     }
 
+    /* VLANs are polled only once they are asked for */
+    auto read = [](nas_stats_obj_t& vlan, uint64_t *stat_values) {
+        interface_ctrl_t intf_ctrl;
+        if (!get_vlan_intf_info(vlan.ifindex, &intf_ctrl)) return false;
+        vlan.name = intf_ctrl.if_name;
+        return read_vlan_stats(intf_ctrl.vlan_id, stat_values);
+    };
+    if (nas_stats_poller_register(NAS_STATS_GRP_VLAN, vlan_stat_ids->size(), read, nullptr) != STD_ERR_OK) {
+        EV_LOG(ERR,INTERFACE, 0,"NAS-STAT", "Failed to start the VLAN stats poller");
+    }
+
     return STD_ERR_OK;
 }
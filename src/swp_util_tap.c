@@ -39,7 +39,6 @@
 
 
 #define SWP_UTIL_TAP_NAME_MAX 17
-#define SWP_UTIL_TAP_QUEUE_LEN_MAX 10
 #define SWP_UTIL_TAP_TXQLEN 1000
 /*
  * \brief Internally managed tap description structure.  Access to fields are unsupported
@@ -0,0 +1,76 @@
+#!/usr/bin/python
+#
+# Copyright (c) 2019 Dell Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may
+# not use this file except in compliance with the License. You may obtain
+# a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+#
+# THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+# CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+# LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+# FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+#
+# See the Apache Version 2.0 License for specific language governing
+# permissions and limitations under the License.
+#
+
+# Latency of a type filtered interface GET against the number of kernel
+# interfaces. Dummy netdevs are added to grow the OS interface dump that the
+# GET handlers filter down to the physical ports.
+
+import cps
+import cps_object
+import subprocess
+import time
+
+KERNEL_INTF_COUNTS = [0, 256, 1024, 4096]
+RUNS = 5
+DUMMY_PREFIX = "nbench"
+
+OBJS = {
+    "interface": ("dell-base-if-cmn/if/interfaces/interface", "if/interfaces/interface/type"),
+    "interface-state": ("dell-base-if-cmn/if/interfaces-state/interface",
+                        "if/interfaces-state/interface/type"),
+}
+
+def add_dummies(start, end):
+    for ix in range(start, end):
+        subprocess.check_call(["ip", "link", "add", DUMMY_PREFIX + str(ix), "type", "dummy"])
+
+def del_dummies(count):
+    for ix in range(count):
+        subprocess.call(["ip", "link", "del", DUMMY_PREFIX + str(ix)])
+
+def time_get(module, type_attr):
+    cps_obj = cps_object.CPSObject(module = module, qual="target")
+    cps_obj.add_attr(type_attr, "ianaift:ethernetCsmacd")
+    total = 0.0
+    found = 0
+    for run in range(RUNS):
+        ret_list = []
+        start = time.time()
+        if not cps.get([cps_obj.get()], ret_list):
+            return None, 0
+        total += time.time() - start
+        found = len(ret_list)
+    return total * 1000 / RUNS, found
+
+def test_get_latency_vs_kernel_intfs():
+    added = 0
+    try:
+        print "%-16s %10s %8s %10s" % ("object", "kernel-if", "ports", "avg-ms")
+        for count in KERNEL_INTF_COUNTS:
+            add_dummies(added, count)
+            added = count
+            for name, (module, type_attr) in sorted(OBJS.items()):
+                ms, found = time_get(module, type_attr)
+                if ms is None:
+                    print "%-16s %10d GET failed" % (name, count)
+                    assert False
+                print "%-16s %10d %8d %10.2f" % (name, count, found, ms)
+    finally:
+        del_dummies(added)
+
+if __name__ == '__main__':
+    test_get_latency_vs_kernel_intfs()
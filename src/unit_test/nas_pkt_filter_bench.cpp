@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2019 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * nas_pkt_filter_bench.cpp
+ *
+ * Packet filter ingress lookup rate against the number of rules.
+ * Half of the rules match on user trap id, the other half on destination
+ * MAC; the rules have no actions so only the lookup is measured.
+ */
+
+#include "nas_int_filter_class.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static constexpr size_t PKT_COUNT = 2000000;
+static constexpr size_t PKT_LEN = 64;
+
+static void pf_bench_fill_table(pf_table& tbl, size_t rules)
+{
+    for (size_t ix = 0; ix < rules; ++ix) {
+        pf_rule pfr;
+        pf_match_t m_tv;
+        memset(&m_tv, 0, sizeof(m_tv));
+
+        if (ix % 2) {
+            m_tv.m_type = BASE_PACKET_PACKET_MATCH_TYPE_HOSTIF_USER_TRAP_ID;
+            m_tv.m_val.u64 = ix;
+        } else {
+            m_tv.m_type = BASE_PACKET_PACKET_MATCH_TYPE_DST_MAC;
+            m_tv.m_val.mac[0] = 0x02;
+            m_tv.m_val.mac[5] = (uint8_t) ix;
+        }
+        pfr.pf_r_add_match_param(m_tv);
+        pfr.pf_r_set_stop(true);
+        tbl.pf_t_add_rule(BASE_PACKET_PACKET_DIRECTION_TYPE_DIR_IN, pfr);
+    }
+}
+
+static double pf_bench_run(size_t rules)
+{
+    pf_table tbl;
+    pf_bench_fill_table(tbl, rules);
+
+    //Packets cycle over twice the rule range, so about half of them match
+    std::vector<uint8_t> pkt(PKT_LEN, 0);
+    pkt[0] = 0x02;
+    pf_pkt_attr attr;
+    memset(&attr, 0, sizeof(attr));
+
+    size_t matched = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t ix = 0; ix < PKT_COUNT; ++ix) {
+        size_t key = ix % (2 * rules);
+        attr.trap_id = key;
+        pkt[5] = (uint8_t) key;
+        if (tbl.pf_t_in_pkt_hndlr(pkt.data(), pkt.size(), &attr)) ++matched;
+    }
+    std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+
+    printf("%8lu %14.0f %10lu\n", rules, PKT_COUNT / secs.count(), matched);
+    return secs.count();
+}
+
+int main()
+{
+    printf("%8s %14s %10s\n", "rules", "packets/sec", "matched");
+    for (size_t rules : {1, 4, 16, 64, 128, 250}) {
+        pf_bench_run(rules);
+    }
+    return 0;
+}
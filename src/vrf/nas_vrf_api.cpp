@@ -34,8 +34,119 @@
 #include "nas_vrf_utils.h"
 #include "nas_int_com_utils.h"
 
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <net/if.h>
+
 static cps_api_event_service_handle_t         _handle;
 
+/* Router interface name by VRF id and if-index, looked up from the interface table on
+ * first use. An entry is removed when its parent is unbound, the router interface is
+ * deleted or the VRF is deleted. Only the name is kept, the rest of the router interface
+ * info is always read from the interface table so it is never served stale. */
+static std::mutex nas_vrf_cache_mtx;
+static std::map<std::pair<hal_vrf_id_t, hal_ifindex_t>, std::string> nas_vrf_rt_intf_cache;
+/* VRF name to internal VRF id */
+static std::unordered_map<std::string, hal_vrf_id_t> nas_vrf_id_cache;
+
+static t_std_error nas_vrf_internal_id_get(const char *vrf_name, hal_vrf_id_t *vrf_id) {
+    {
+        std::lock_guard<std::mutex> lock(nas_vrf_cache_mtx);
+        auto it = nas_vrf_id_cache.find(vrf_name);
+        if (it != nas_vrf_id_cache.end()) {
+            *vrf_id = it->second;
+            return STD_ERR_OK;
+        }
+    }
+    t_std_error rc = nas_get_vrf_internal_id_from_vrf_name(vrf_name, vrf_id);
+    if (rc == STD_ERR_OK) {
+        std::lock_guard<std::mutex> lock(nas_vrf_cache_mtx);
+        nas_vrf_id_cache[vrf_name] = *vrf_id;
+    }
+    return rc;
+}
+
+static bool nas_vrf_rt_intf_name_get(hal_vrf_id_t vrf_id, hal_ifindex_t if_index, std::string &if_name) {
+    auto key = std::make_pair(vrf_id, if_index);
+    {
+        std::lock_guard<std::mutex> lock(nas_vrf_cache_mtx);
+        auto it = nas_vrf_rt_intf_cache.find(key);
+        if (it != nas_vrf_rt_intf_cache.end()) {
+            if_name = it->second;
+            return true;
+        }
+    }
+    interface_ctrl_t intf_ctrl;
+    memset(&intf_ctrl, 0, sizeof(interface_ctrl_t));
+    intf_ctrl.q_type = HAL_INTF_INFO_FROM_IF;
+    intf_ctrl.vrf_id = vrf_id;
+    intf_ctrl.if_index = if_index;
+
+    if ((dn_hal_get_interface_info(&intf_ctrl)) != STD_ERR_OK) {
+        NAS_VRF_LOG_ERR("VRF-INTF-GET", "Invalid interface VRF-id:%d if-index:%d.",
+                        vrf_id, if_index);
+        return false;
+    }
+    if_name = intf_ctrl.if_name;
+
+    std::lock_guard<std::mutex> lock(nas_vrf_cache_mtx);
+    nas_vrf_rt_intf_cache[key] = if_name;
+    return true;
+}
+
+void nas_vrf_rt_intf_cache_del(hal_vrf_id_t vrf_id, hal_ifindex_t if_index) {
+    std::lock_guard<std::mutex> lock(nas_vrf_cache_mtx);
+    nas_vrf_rt_intf_cache.erase(std::make_pair(vrf_id, if_index));
+}
+
+/* Get the parent interface info by name, returns false if it does not exist */
+static bool nas_vrf_parent_intf_ctrl_get(const char *if_name, interface_ctrl_t *intf_ctrl) {
+    memset(intf_ctrl, 0, sizeof(interface_ctrl_t));
+    intf_ctrl->q_type = HAL_INTF_INFO_FROM_IF_NAME;
+    safestrncpy(intf_ctrl->if_name, (const char *)if_name,
+                sizeof(intf_ctrl->if_name));
+
+    return (dn_hal_get_interface_info(intf_ctrl) == STD_ERR_OK);
+}
+
+/* Get the router interface info of a parent interface, or the parent interface info
+ * itself if it has no router interface. */
+static t_std_error nas_vrf_rt_intf_ctrl_from_parent(interface_ctrl_t *intf_ctrl) {
+    /* See if we have router interface on the parent interface,
+     * if present, return interface info for that interface. */
+    if (intf_ctrl->l3_intf_info.if_index == 0) {
+        return STD_ERR_OK;
+    }
+    hal_vrf_id_t rt_vrf_id = intf_ctrl->l3_intf_info.vrf_id;
+    hal_ifindex_t rt_if_index = intf_ctrl->l3_intf_info.if_index;
+
+    memset(intf_ctrl, 0, sizeof(interface_ctrl_t));
+    intf_ctrl->q_type = HAL_INTF_INFO_FROM_IF;
+    intf_ctrl->vrf_id = rt_vrf_id;
+    intf_ctrl->if_index = rt_if_index;
+
+    if ((dn_hal_get_interface_info(intf_ctrl)) != STD_ERR_OK) {
+        NAS_VRF_LOG_ERR("VRF-INTF-GET", "Invalid interface VRF-id:%d if-index:%d.",
+                        rt_vrf_id, rt_if_index);
+        return STD_ERR(ROUTE,FAIL,0);
+    }
+    return STD_ERR_OK;
+}
+
+/* Get the router interface info for a parent interface looked up by name, or the parent
+ * interface info itself if it has no router interface. */
+static t_std_error nas_vrf_rt_intf_ctrl_get(const char *if_name, interface_ctrl_t *intf_ctrl) {
+    if (!nas_vrf_parent_intf_ctrl_get(if_name, intf_ctrl)) {
+        NAS_VRF_LOG_ERR("VRF-INTF-GET", "Invalid interface %s interface get failed ",
+                        if_name);
+        return STD_ERR(ROUTE,FAIL,0);
+    }
+    return nas_vrf_rt_intf_ctrl_from_parent(intf_ctrl);
+}
+
 t_std_error nas_vrf_create_publish_handle() {
     if (cps_api_event_client_connect(&_handle) != cps_api_ret_code_OK) {
         NAS_VRF_LOG_ERR("VRF-PUB", "Failed to create the handle for event publish!");
@@ -56,36 +167,13 @@ cps_api_return_code_t nas_vrf_get_intf_info(cps_api_object_list_t list, const ch
                                             const char *if_name) {
     interface_ctrl_t intf_ctrl;
 
-    memset(&intf_ctrl, 0, sizeof(interface_ctrl_t));
-    intf_ctrl.q_type = HAL_INTF_INFO_FROM_IF_NAME;
-    safestrncpy(intf_ctrl.if_name, (const char *)if_name,
-                sizeof(intf_ctrl.if_name));
-
-    if ((dn_hal_get_interface_info(&intf_ctrl)) != STD_ERR_OK) {
-        NAS_VRF_LOG_ERR("VRF-INTF-GET", "Invalid interface %s interface get failed ",
-                        if_name);
+    if (nas_vrf_rt_intf_ctrl_get(if_name, &intf_ctrl) != STD_ERR_OK) {
         return cps_api_ret_code_ERR;
     }
-    /* See if we have router interface on the parent interface,
-     * if present, return interface info for that interface. */
-    if (intf_ctrl.l3_intf_info.if_index != 0) {
-        hal_vrf_id_t rt_vrf_id = intf_ctrl.l3_intf_info.vrf_id;
-        hal_ifindex_t rt_if_index = intf_ctrl.l3_intf_info.if_index;
-        memset(&intf_ctrl, 0, sizeof(interface_ctrl_t));
-        intf_ctrl.q_type = HAL_INTF_INFO_FROM_IF;
-        intf_ctrl.vrf_id = rt_vrf_id;
-        intf_ctrl.if_index = rt_if_index;
-
-        if ((dn_hal_get_interface_info(&intf_ctrl)) != STD_ERR_OK) {
-            NAS_VRF_LOG_ERR("VRF-INTF-GET", "Invalid interface VRF-id:%d if-index:%d.",
-                            rt_vrf_id, rt_if_index);
-            return cps_api_ret_code_ERR;
-        }
-    }
 
     if (vrf_name) {
         hal_vrf_id_t vrf_id = 0;
-        if (nas_get_vrf_internal_id_from_vrf_name(vrf_name, &vrf_id) != STD_ERR_OK) {
+        if (nas_vrf_internal_id_get(vrf_name, &vrf_id) != STD_ERR_OK) {
             NAS_VRF_LOG_ERR("VRF-INTF-GET", "Invalid VRF name:%s ",
                             vrf_name);
             return cps_api_ret_code_ERR;
@@ -134,36 +222,8 @@ cps_api_return_code_t nas_vrf_get_intf_info(cps_api_object_list_t list, const ch
 }
 
 /* This function provides router interface to parent interface mapping */
-cps_api_return_code_t nas_vrf_get_router_intf_info(cps_api_object_list_t list, const char *if_name) {
-    interface_ctrl_t intf_ctrl;
-
-    memset(&intf_ctrl, 0, sizeof(interface_ctrl_t));
-    intf_ctrl.q_type = HAL_INTF_INFO_FROM_IF_NAME;
-    safestrncpy(intf_ctrl.if_name, (const char *)if_name,
-                sizeof(intf_ctrl.if_name));
-
-    if ((dn_hal_get_interface_info(&intf_ctrl)) != STD_ERR_OK) {
-        NAS_VRF_LOG_ERR("VRF-INTF-GET", "Invalid interface %s interface get failed ",
-                        if_name);
-        return cps_api_ret_code_ERR;
-    }
-    /* See if we have router interface on the parent interface,
-     * if present, return interface info for that interface. */
-    if (intf_ctrl.l3_intf_info.if_index != 0) {
-        hal_vrf_id_t rt_vrf_id = intf_ctrl.l3_intf_info.vrf_id;
-        hal_ifindex_t rt_if_index = intf_ctrl.l3_intf_info.if_index;
-        memset(&intf_ctrl, 0, sizeof(interface_ctrl_t));
-        intf_ctrl.q_type = HAL_INTF_INFO_FROM_IF;
-        intf_ctrl.vrf_id = rt_vrf_id;
-        intf_ctrl.if_index = rt_if_index;
-
-        if ((dn_hal_get_interface_info(&intf_ctrl)) != STD_ERR_OK) {
-            NAS_VRF_LOG_ERR("VRF-INTF-GET", "Invalid interface VRF-id:%d if-index:%d.",
-                            rt_vrf_id, rt_if_index);
-            return cps_api_ret_code_ERR;
-        }
-    }
-
+static cps_api_return_code_t nas_vrf_add_router_intf_obj(cps_api_object_list_t list, const char *if_name,
+                                                         const char *rt_if_name, hal_ifindex_t rt_if_index) {
     cps_api_object_t obj = cps_api_object_create();
     if(obj == NULL){
         NAS_VRF_LOG_ERR("VRF-INTF-GET", "Failed to allocate memory to cps object");
@@ -186,10 +246,10 @@ cps_api_return_code_t nas_vrf_get_router_intf_info(cps_api_object_list_t list, c
     */
     cps_api_object_attr_add(obj,VRF_MGMT_ROUTER_INTF_ENTRY_NAME, if_name, strlen(if_name)+1);
 
-    cps_api_object_attr_add(obj, VRF_MGMT_ROUTER_INTF_ENTRY_IFNAME, (const void *)intf_ctrl.if_name,
-                            strlen(intf_ctrl.if_name)+1);
+    cps_api_object_attr_add(obj, VRF_MGMT_ROUTER_INTF_ENTRY_IFNAME, (const void *)rt_if_name,
+                            strlen(rt_if_name)+1);
 
-    cps_api_object_attr_add_u32(obj, VRF_MGMT_ROUTER_INTF_ENTRY_IFINDEX, intf_ctrl.if_index);
+    cps_api_object_attr_add_u32(obj, VRF_MGMT_ROUTER_INTF_ENTRY_IFINDEX, rt_if_index);
 
     if (!cps_api_object_list_append(list,obj)) {
         cps_api_object_delete(obj);
@@ -201,6 +261,48 @@ cps_api_return_code_t nas_vrf_get_router_intf_info(cps_api_object_list_t list, c
 }
 
 
+cps_api_return_code_t nas_vrf_get_router_intf_info(cps_api_object_list_t list, const char *if_name) {
+    interface_ctrl_t intf_ctrl;
+
+    if (nas_vrf_rt_intf_ctrl_get(if_name, &intf_ctrl) != STD_ERR_OK) {
+        return cps_api_ret_code_ERR;
+    }
+    return nas_vrf_add_router_intf_obj(list, if_name, intf_ctrl.if_name, intf_ctrl.if_index);
+}
+
+/* Dump the router interfaces of all the parent interfaces bound to a non-default VRF. The
+ * interface table is walked once with one lookup per interface, the router interface
+ * name comes from the cache. */
+cps_api_return_code_t nas_vrf_get_all_router_intf_info(cps_api_object_list_t list) {
+    struct if_nameindex *if_list = if_nameindex();
+    if (if_list == nullptr) {
+        NAS_VRF_LOG_ERR("VRF-INTF-GET", "Failed to get the interface list");
+        return cps_api_ret_code_ERR;
+    }
+    cps_api_return_code_t rc = cps_api_ret_code_OK;
+    for (struct if_nameindex *it = if_list; it->if_index != 0; ++it) {
+        interface_ctrl_t intf_ctrl;
+        if (!nas_vrf_parent_intf_ctrl_get(it->if_name, &intf_ctrl)) continue;
+
+        /* Not bound to a non-default VRF or router interface not created yet */
+        if ((intf_ctrl.l3_intf_info.if_index == 0) ||
+            (intf_ctrl.l3_intf_info.vrf_id == NAS_DEFAULT_VRF_ID)) continue;
+
+        std::string rt_if_name;
+        if (!nas_vrf_rt_intf_name_get(intf_ctrl.l3_intf_info.vrf_id, intf_ctrl.l3_intf_info.if_index,
+                                      rt_if_name)) {
+            continue;
+        }
+        if (nas_vrf_add_router_intf_obj(list, it->if_name, rt_if_name.c_str(),
+                                        intf_ctrl.l3_intf_info.if_index) != cps_api_ret_code_OK) {
+            rc = cps_api_ret_code_ERR;
+            break;
+        }
+    }
+    if_freenameindex(if_list);
+    return rc;
+}
+
 /* @@TODO The assumption here for VRF oid delete is all the dependent modules
  * have cleaned-up the VRF oid dependent data */
 bool nas_vrf_update_vrf_id(const char *vrf_name, bool is_add) {
@@ -238,6 +340,20 @@ bool nas_vrf_update_vrf_id(const char *vrf_name, bool is_add) {
             }
         }
     }
+    if (!is_add) {
+        hal_vrf_id_t vrf_id = 0;
+        bool vrf_id_valid = (nas_vrf_internal_id_get(vrf_name, &vrf_id) == STD_ERR_OK);
+
+        std::lock_guard<std::mutex> lock(nas_vrf_cache_mtx);
+        nas_vrf_id_cache.erase(vrf_name);
+        for (auto it = nas_vrf_rt_intf_cache.begin(); vrf_id_valid && (it != nas_vrf_rt_intf_cache.end());) {
+            if (it->first.first == vrf_id) {
+                it = nas_vrf_rt_intf_cache.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
     safestrncpy(vrf_info.vrf_name, vrf_name, sizeof(vrf_info.vrf_name));
     if (nas_update_vrf_info((is_add ? NAS_VRF_OP_ADD : NAS_VRF_OP_DEL), &vrf_info) != STD_ERR_OK) {
         NAS_VRF_LOG_ERR("VRF-ID-GET", "VRF oid update failed for VRF:%s is_add:%d", vrf_name, is_add);
@@ -535,6 +651,7 @@ cps_api_return_code_t nas_intf_bind_vrf_rpc_handler (void *context, cps_api_tran
             return cps_api_ret_code_ERR;
         }
         nas_intf_handle_intf_mode_change(if_name, BASE_IF_MODE_MODE_L3);
+        nas_vrf_rt_intf_cache_del(intf_ctrl.vrf_id, intf_ctrl.if_index);
 
         NAS_VRF_LOG_INFO("INTF-VRF-RPC", "OS VRF:%s Parent Intf:%s rt-intf VRF-id:%d intf:%s(%d)"
                          " disassociated with VRF successful", vrf_name,
@@ -138,7 +138,7 @@ static cps_api_return_code_t nas_vrf_cps_vrf_get_func (void *ctx,
         /* get all VRF intf info */
         std::vector <nas_vrf_ctrl_t> vrf_ctrl_lst;
         nas_get_all_vrf_ctrl(vrf_ctrl_lst);
-        for (auto vrf_ctrl_block : vrf_ctrl_lst) {
+        for (const auto &vrf_ctrl_block : vrf_ctrl_lst) {
             if (nas_vrf_add_obj(vrf_ctrl_block, param->list) != cps_api_ret_code_OK) {
                 return cps_api_ret_code_ERR;
             }
@@ -221,8 +221,8 @@ static cps_api_return_code_t nas_vrf_cps_vrf_router_intf_get_func (void *ctx,
     const char *if_name  = (const char *)cps_api_object_get_data(filt, VRF_MGMT_ROUTER_INTF_ENTRY_NAME);
 
     if (if_name == nullptr) {
-        NAS_VRF_LOG_DEBUG("NAS-RT-CPS","No If-name, VRF-Intf get failed!");
-        return cps_api_ret_code_ERR;
+        /* No If-name, get all router interfaces */
+        return nas_vrf_get_all_router_intf_info(param->list);
     }
 
     if((rc = nas_vrf_get_router_intf_info(param->list, if_name)) != STD_ERR_OK){